@@ -0,0 +1,78 @@
+#include "DirectMidiProcessor.h"
+
+#include "ui/components/MidiLearnComponent.h"
+
+namespace {
+constexpr int COLLECT_INTERVAL_MS = 1;
+}  // namespace
+
+DirectMidiProcessor::DirectMidiProcessor(Omnify& omnify, MidiMessageScheduler& scheduler, juce::CriticalSection& engineLock, MidiOutputThread& output)
+    : omnify(omnify), scheduler(scheduler), engineLock(engineLock), output(output) {
+    dueMessages.ensureSize(MidiMessageScheduler::DEFAULT_CAPACITY * 8);
+}
+
+DirectMidiProcessor::~DirectMidiProcessor() { stopTimer(); }
+
+void DirectMidiProcessor::start(double newSampleRate, int64_t startSample) {
+    stopTimer();
+
+    {
+        // The input thread reads the anchor under the lock, so it never sees half of one
+        const juce::ScopedLock lock(engineLock);
+        sampleRate.store(newSampleRate);
+        anchorSample.store(startSample);
+        anchorTicks.store(juce::Time::getHighResolutionTicks());
+        lastCollectedSample = startSample;
+    }
+
+    startTimer(COLLECT_INTERVAL_MS);
+}
+
+void DirectMidiProcessor::stop() { stopTimer(); }
+
+int64_t DirectMidiProcessor::nowSample() const {
+    auto elapsedTicks = juce::Time::getHighResolutionTicks() - anchorTicks.load();
+    auto elapsedSeconds = static_cast<double>(elapsedTicks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    return anchorSample.load() + static_cast<int64_t>(elapsedSeconds * sampleRate.load());
+}
+
+void DirectMidiProcessor::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message) {
+    MidiLearnComponent::broadcastMidi(message);
+
+    const juce::ScopedLock lock(engineLock);
+    try {
+        handledEvents.clear();
+        if (!omnify.handle(message, nowSample(), handledEvents, Omnify::INPUT_THREAD_READER)) {
+            output.sendNow(message);
+            omnify.getStats().recordEventsOut(1);
+            return;
+        }
+        // Strum sweep fill-ins are placed before this message, which has already arrived, so they just go first
+        for (const auto& msg : handledEvents) {
+            output.sendNow(msg);
+        }
+        omnify.getStats().recordEventsOut(handledEvents.size());
+        omnify.getStats().recordScheduler(scheduler.size(), scheduler.getOverflowCount());
+    } catch (const std::exception& e) {
+        DBG("DirectMidiProcessor: exception in handle(): " << e.what());
+    }
+}
+
+void DirectMidiProcessor::hiResTimerCallback() {
+    const juce::ScopedLock lock(engineLock);
+    if (scheduler.isEmpty()) {
+        return;
+    }
+
+    auto now = nowSample();
+    dueMessages.clear();
+    scheduler.collectOverdueMessages(lastCollectedSample, now, dueMessages);
+    lastCollectedSample = now;
+    omnify.getTrace().record(TraceRing::Kind::COLLECT, TraceRing::Track::NOTE_OFF_TIMER, 0, dueMessages.getNumEvents());
+
+    for (const auto metadata : dueMessages) {
+        output.sendNow(metadata.getMessage());
+    }
+    omnify.getStats().recordEventsOut(static_cast<uint64_t>(dueMessages.getNumEvents()));
+    omnify.getStats().recordScheduler(scheduler.size(), scheduler.getOverflowCount());
+}
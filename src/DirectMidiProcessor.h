@@ -0,0 +1,61 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <atomic>
+#include <cstdint>
+
+#include "MidiEventSink.h"
+#include "MidiMessageScheduler.h"
+#include "MidiOutputThread.h"
+#include "Omnify.h"
+
+/**
+ * Direct mode: runs Omnify on the midi input thread as each message arrives and sends the result to the output
+ * device immediately, instead of waiting for the next audio block. Only used when both input and output are devices.
+ *
+ * Time comes from the high resolution clock, converted to samples and anchored to the audio thread's sample position
+ * when direct mode starts, so strum cooldowns and scheduled note-offs carry over when switching modes. A 1ms
+ * high resolution timer sends the scheduler's note-offs as they come due.
+ *
+ * Omnify and the scheduler aren't thread safe, so everything that touches them (here and in processBlock) holds
+ * engineLock. The audio thread only ever try-locks it.
+ */
+class DirectMidiProcessor : public juce::MidiInputCallback, private juce::HighResolutionTimer {
+   public:
+    DirectMidiProcessor(Omnify& omnify, MidiMessageScheduler& scheduler, juce::CriticalSection& engineLock, MidiOutputThread& output);
+    ~DirectMidiProcessor() override;
+
+    // Message thread. startSample is where the audio thread's clock had got to.
+    void start(double sampleRate, int64_t startSample);
+    void stop();
+
+    // The current time in samples, on the same timeline as the audio thread's sample position
+    int64_t nowSample() const;
+
+    // Input thread
+    void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
+
+   private:
+    void hiResTimerCallback() override;
+
+    Omnify& omnify;
+    MidiMessageScheduler& scheduler;
+    juce::CriticalSection& engineLock;
+    MidiOutputThread& output;
+
+    std::atomic<double> sampleRate{44100.0};
+    std::atomic<int64_t> anchorSample{0};
+    std::atomic<int64_t> anchorTicks{0};
+
+    // nowSample() is called from the audio thread
+    static_assert(std::atomic<double>::is_always_lock_free);
+    static_assert(std::atomic<int64_t>::is_always_lock_free);
+
+    // Guarded by engineLock
+    MidiEventSink handledEvents;
+    juce::MidiBuffer dueMessages;
+    int64_t lastCollectedSample = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(DirectMidiProcessor)
+};
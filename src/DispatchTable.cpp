@@ -0,0 +1,42 @@
+#include "DispatchTable.h"
+
+#include <variant>
+
+DispatchTable::DispatchTable(const OmnifySettings& s) {
+    const auto* qualityButtons = std::get_if<ButtonPerChordQuality>(&s.chordQualitySelectionStyle.value);
+    const auto* qualityRange = std::get_if<CCRangePerChordQuality>(&s.chordQualitySelectionStyle.value);
+
+    for (int note = 0; note < 128; note++) {
+        auto& entry = noteOns[static_cast<size_t>(note)];
+        if (qualityButtons && qualityButtons->notes.count(note) > 0) {
+            entry = {Action::CHORD_QUALITY, qualityButtons->notes.at(note)};
+        } else if (s.stopButton.note == note) {
+            entry.action = Action::STOP;
+        } else if (s.latchButton.note == note) {
+            entry.action = Action::LATCH_FLIP;
+        } else {
+            entry.action = Action::CHORD;
+        }
+    }
+
+    for (int cc = 0; cc < 128; cc++) {
+        for (int high = 0; high <= 1; high++) {
+            auto& entry = ccs[static_cast<size_t>((cc << 1) | high)];
+            if (qualityButtons && high && qualityButtons->ccs.count(cc) > 0) {
+                entry = {Action::CHORD_QUALITY, qualityButtons->ccs.at(cc)};
+            } else if (qualityRange && qualityRange->cc == cc) {
+                entry.action = Action::CHORD_QUALITY_RANGE;
+            } else if (s.stopButton.cc == cc) {
+                entry.action = Action::STOP;
+            } else if (s.latchButton.cc == cc) {
+                if (s.latchButton.ccIsToggle) {
+                    entry.action = high ? Action::LATCH_ON : Action::LATCH_OFF;
+                } else {
+                    entry.action = Action::LATCH_FLIP;
+                }
+            } else if (s.strumPlateCC == cc) {
+                entry.action = Action::STRUM;
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "datamodel/ChordQuality.h"
+#include "datamodel/OmnifySettings.h"
+
+/**
+ * What Omnify does with each note-on and cc, compiled from the settings whenever they change, so handle() resolves a
+ * message with one array lookup instead of asking each handler in turn.
+ *
+ * The table reproduces the order the handlers used to be tried in: chord quality buttons, then the stop button, then
+ * the latch button, then chords (note-ons) or the strum plate (ccs). A chord quality cc button only fires above 63,
+ * so ccs get an entry for each half of the value range, and a low value falls through to whatever comes next.
+ * Note-offs aren't in the table: the only thing that uses them is releasing the current chord.
+ */
+class DispatchTable {
+   public:
+    enum class Action : uint8_t {
+        PASSTHROUGH,
+        CHORD_QUALITY,        // select quality
+        CHORD_QUALITY_RANGE,  // select the quality for the cc value's ninth of the range
+        STOP,
+        LATCH_FLIP,
+        LATCH_ON,
+        LATCH_OFF,
+        CHORD,
+        STRUM,
+    };
+
+    struct Entry {
+        Action action = Action::PASSTHROUGH;
+        ChordQuality quality = ChordQuality::MAJOR;
+    };
+
+    DispatchTable() = default;
+    explicit DispatchTable(const OmnifySettings& s);
+
+    // note-ons with velocity > 0
+    const Entry& forNoteOn(int note) const { return noteOns[static_cast<size_t>(note)]; }
+    const Entry& forCc(int controller, int value) const { return ccs[static_cast<size_t>((controller << 1) | (value >> 6))]; }
+
+   private:
+    std::array<Entry, 128> noteOns{};
+    std::array<Entry, 256> ccs{};  // (controller << 1) | (value > 63)
+};
+
+// The settings as the engine reads them: the settings plus everything compiled from them, published as one snapshot
+// so the two can never disagree.
+struct CompiledSettings : OmnifySettings {
+    explicit CompiledSettings(const OmnifySettings& s)
+        : OmnifySettings(s),
+          dispatch(s),
+          chordTable(s.chordVoicingStyle->table().slice(s.voicingModifier)),
+          strumTable(&s.strumVoicingStyle->table()) {}
+
+    DispatchTable dispatch;
+
+    // The voicing styles' tables, resolved up front so a chord or strum goes straight to its voicing: no virtual
+    // style to ask, and the modifier already picked
+    ChordVoicingTable::Slice chordTable;
+    const StrumVoicingTable* strumTable;
+};
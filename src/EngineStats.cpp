@@ -0,0 +1,143 @@
+#include "EngineStats.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+constexpr int SUB_BUCKETS = 4;  // per doubling
+
+template <typename T>
+void storeMax(std::atomic<T>& target, T value) {
+    T current = target.load(std::memory_order_relaxed);
+    while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+double perSecond(uint64_t count, int64_t ns) { return ns > 0 ? static_cast<double>(count) * 1.0e9 / static_cast<double>(ns) : 0.0; }
+}  // namespace
+
+int EngineStats::bucketForNs(int64_t ns) {
+    auto units = static_cast<uint64_t>(std::max<int64_t>(ns, 0) / BUCKET_UNIT_NS);
+    if (units < SUB_BUCKETS) {
+        return static_cast<int>(units);
+    }
+    int exponent = static_cast<int>(std::bit_width(units)) - 1;  // >= 2
+    int bucket = (exponent - 1) * SUB_BUCKETS + static_cast<int>((units >> (exponent - 2)) & (SUB_BUCKETS - 1));
+    return std::min(bucket, HISTOGRAM_BUCKETS - 1);
+}
+
+int64_t EngineStats::bucketLowerBoundNs(int bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket * BUCKET_UNIT_NS;
+    }
+    int exponent = bucket / SUB_BUCKETS + 1;
+    int64_t units = static_cast<int64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << (exponent - 2);
+    return units * BUCKET_UNIT_NS;
+}
+
+void EngineStats::reset() {
+    for (auto& bucket : blockTimeHistogram) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    blocks.store(0, std::memory_order_relaxed);
+    overruns.store(0, std::memory_order_relaxed);
+    maxBlockNs.store(0, std::memory_order_relaxed);
+    processedNs.store(0, std::memory_order_relaxed);
+    eventsIn.store(0, std::memory_order_relaxed);
+    eventsOut.store(0, std::memory_order_relaxed);
+    ccsCoalesced.store(0, std::memory_order_relaxed);
+    eventsOverBudget.store(0, std::memory_order_relaxed);
+    strumsSuppressedByCooldown.store(0, std::memory_order_relaxed);
+    strumsSuppressedByDeadZone.store(0, std::memory_order_relaxed);
+    strumVoicesStolen.store(0, std::memory_order_relaxed);
+    schedulerOverflows.store(0, std::memory_order_relaxed);
+    schedulerDepth.store(0, std::memory_order_relaxed);
+    maxSchedulerDepth.store(0, std::memory_order_relaxed);
+}
+
+void EngineStats::recordBlock(int64_t elapsedNs, int64_t blockDurationNs) {
+    blockTimeHistogram[static_cast<size_t>(bucketForNs(elapsedNs))].fetch_add(1, std::memory_order_relaxed);
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    processedNs.fetch_add(blockDurationNs, std::memory_order_relaxed);
+    storeMax(maxBlockNs, elapsedNs);
+    if (elapsedNs > blockDurationNs) {
+        overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void EngineStats::recordScheduler(size_t depth, uint64_t overflows) {
+    schedulerDepth.store(depth, std::memory_order_relaxed);
+    storeMax(maxSchedulerDepth, static_cast<uint64_t>(depth));
+    schedulerOverflows.store(overflows, std::memory_order_relaxed);
+}
+
+EngineStats::Snapshot EngineStats::snapshot() const {
+    Snapshot s;
+    for (size_t i = 0; i < blockTimeHistogram.size(); i++) {
+        s.blockTimeHistogram[i] = blockTimeHistogram[i].load(std::memory_order_relaxed);
+    }
+    s.blocks = blocks.load(std::memory_order_relaxed);
+    s.overruns = overruns.load(std::memory_order_relaxed);
+    s.maxBlockNs = maxBlockNs.load(std::memory_order_relaxed);
+    s.processedNs = processedNs.load(std::memory_order_relaxed);
+    s.eventsIn = eventsIn.load(std::memory_order_relaxed);
+    s.eventsOut = eventsOut.load(std::memory_order_relaxed);
+    s.ccsCoalesced = ccsCoalesced.load(std::memory_order_relaxed);
+    s.eventsOverBudget = eventsOverBudget.load(std::memory_order_relaxed);
+    s.strumsSuppressedByCooldown = strumsSuppressedByCooldown.load(std::memory_order_relaxed);
+    s.strumsSuppressedByDeadZone = strumsSuppressedByDeadZone.load(std::memory_order_relaxed);
+    s.strumVoicesStolen = strumVoicesStolen.load(std::memory_order_relaxed);
+    s.schedulerOverflows = schedulerOverflows.load(std::memory_order_relaxed);
+    s.schedulerDepth = schedulerDepth.load(std::memory_order_relaxed);
+    s.maxSchedulerDepth = maxSchedulerDepth.load(std::memory_order_relaxed);
+    return s;
+}
+
+int64_t EngineStats::Snapshot::blockTimePercentileNs(double fraction) const {
+    uint64_t total = 0;
+    for (auto count : blockTimeHistogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total - 1));
+    uint64_t seen = 0;
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+        seen += blockTimeHistogram[static_cast<size_t>(bucket)];
+        if (seen > rank) {
+            if (bucket == HISTOGRAM_BUCKETS - 1) {
+                return maxBlockNs;
+            }
+            return std::min(bucketLowerBoundNs(bucket + 1), maxBlockNs);
+        }
+    }
+    return maxBlockNs;
+}
+
+double EngineStats::Snapshot::eventsInPerSecond(const Snapshot& since) const {
+    return perSecond(eventsIn - since.eventsIn, processedNs - since.processedNs);
+}
+
+double EngineStats::Snapshot::eventsOutPerSecond(const Snapshot& since) const {
+    return perSecond(eventsOut - since.eventsOut, processedNs - since.processedNs);
+}
+
+juce::String EngineStats::Snapshot::toString() const {
+    auto micros = [](int64_t ns) { return juce::String(static_cast<double>(ns) / 1000.0, 1) + " us"; };
+
+    juce::String s;
+    s << "blocks: " << juce::String(blocks) << ", overruns: " << juce::String(overruns) << "\n";
+    s << "block time p50: " << micros(blockTimePercentileNs(0.5)) << ", p99: " << micros(blockTimePercentileNs(0.99))
+      << ", max: " << micros(maxBlockNs) << "\n";
+    s << "events in: " << juce::String(eventsIn) << " (" << juce::String(eventsInPerSecond(Snapshot{}), 1) << "/s)"
+      << ", out: " << juce::String(eventsOut) << " (" << juce::String(eventsOutPerSecond(Snapshot{}), 1) << "/s)\n";
+    s << "ccs coalesced: " << juce::String(ccsCoalesced) << ", dropped over budget: " << juce::String(eventsOverBudget) << "\n";
+    s << "strums suppressed by cooldown: " << juce::String(strumsSuppressedByCooldown)
+      << ", by dead zone: " << juce::String(strumsSuppressedByDeadZone) << ", strum voices stolen: " << juce::String(strumVoicesStolen)
+      << "\n";
+    s << "scheduler depth: " << juce::String(schedulerDepth) << ", max: " << juce::String(maxSchedulerDepth)
+      << ", overflows: " << juce::String(schedulerOverflows);
+    return s;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Counters for the engine's hot path: how long blocks take, how many events go in and out, how deep the scheduler
+ * gets, how many strums were swallowed, and how often a block took longer than the audio it covers.
+ *
+ * Every field is a lock-free atomic, written with relaxed increments from whichever thread is running the engine and
+ * read from any other thread (the editor, a headless tool) through snapshot(). A snapshot isn't one consistent
+ * instant, but each counter in it is exact.
+ */
+class EngineStats {
+   public:
+    // Block times go into log-linear buckets: 4 per doubling, starting at BUCKET_UNIT_NS. The last bucket also holds
+    // everything too slow for it (about half a second and up); max is kept exactly.
+    static constexpr int HISTOGRAM_BUCKETS = 80;
+    static constexpr int64_t BUCKET_UNIT_NS = 256;
+
+    struct Snapshot {
+        std::array<uint64_t, HISTOGRAM_BUCKETS> blockTimeHistogram{};
+        uint64_t blocks = 0;
+        uint64_t overruns = 0;  // blocks that took longer to process than the audio they cover
+        int64_t maxBlockNs = 0;
+        int64_t processedNs = 0;  // audio time covered by the recorded blocks
+        uint64_t eventsIn = 0;
+        uint64_t eventsOut = 0;
+        uint64_t ccsCoalesced = 0;      // dropped by MidiFloodGuard as superseded, before reaching eventsIn
+        uint64_t eventsOverBudget = 0;  // dropped by MidiFloodGuard past the per-block budget
+        uint64_t strumsSuppressedByCooldown = 0;
+        uint64_t strumsSuppressedByDeadZone = 0;
+        uint64_t strumVoicesStolen = 0;  // cut off to stay within the strum polyphony limit
+        uint64_t schedulerOverflows = 0;
+        uint64_t schedulerDepth = 0;  // at the end of the last block
+        uint64_t maxSchedulerDepth = 0;
+
+        // Upper bound of the bucket holding the given fraction (0-1) of block times, capped at the max. 0 if no blocks.
+        int64_t blockTimePercentileNs(double fraction) const;
+
+        // Rates over the audio time since an earlier snapshot; pass Snapshot{} for the whole run
+        double eventsInPerSecond(const Snapshot& since) const;
+        double eventsOutPerSecond(const Snapshot& since) const;
+
+        // One line per stat, for logs and the headless tools
+        juce::String toString() const;
+    };
+
+    // Not safe to call while the engine is running
+    void reset();
+
+    // Engine thread
+    void recordBlock(int64_t elapsedNs, int64_t blockDurationNs);
+    void recordEventIn() { eventsIn.fetch_add(1, std::memory_order_relaxed); }
+    void recordEventsOut(uint64_t count) { eventsOut.fetch_add(count, std::memory_order_relaxed); }
+    void recordCcsCoalesced(uint64_t count) { ccsCoalesced.fetch_add(count, std::memory_order_relaxed); }
+    void recordEventsOverBudget(uint64_t count) { eventsOverBudget.fetch_add(count, std::memory_order_relaxed); }
+    void recordStrumSuppressedByCooldown() { strumsSuppressedByCooldown.fetch_add(1, std::memory_order_relaxed); }
+    void recordStrumSuppressedByDeadZone() { strumsSuppressedByDeadZone.fetch_add(1, std::memory_order_relaxed); }
+    void recordStrumVoiceStolen() { strumVoicesStolen.fetch_add(1, std::memory_order_relaxed); }
+    void recordScheduler(size_t depth, uint64_t overflows);
+
+    // Any thread
+    Snapshot snapshot() const;
+
+    static int bucketForNs(int64_t ns);
+    static int64_t bucketLowerBoundNs(int bucket);
+
+   private:
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> blockTimeHistogram{};
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> overruns{0};
+    std::atomic<int64_t> maxBlockNs{0};
+    std::atomic<int64_t> processedNs{0};
+    std::atomic<uint64_t> eventsIn{0};
+    std::atomic<uint64_t> eventsOut{0};
+    std::atomic<uint64_t> ccsCoalesced{0};
+    std::atomic<uint64_t> eventsOverBudget{0};
+    std::atomic<uint64_t> strumsSuppressedByCooldown{0};
+    std::atomic<uint64_t> strumsSuppressedByDeadZone{0};
+    std::atomic<uint64_t> strumVoicesStolen{0};
+    std::atomic<uint64_t> schedulerOverflows{0};
+    std::atomic<uint64_t> schedulerDepth{0};
+    std::atomic<uint64_t> maxSchedulerDepth{0};
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<int64_t>::is_always_lock_free);
+};
@@ -0,0 +1,60 @@
+#include "MidiDeviceWatcher.h"
+
+MidiDeviceWatcher::MidiDeviceWatcher() : juce::Thread("Omnify MIDI Device Watcher") {
+    // Called on the message thread when the OS reports a change; the enumeration itself happens on our thread
+    deviceListConnection = juce::MidiDeviceListConnection::make([this]() { notify(); });
+    startThread(juce::Thread::Priority::low);
+}
+
+MidiDeviceWatcher::~MidiDeviceWatcher() {
+    deviceListConnection = {};
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+}
+
+juce::StringArray MidiDeviceWatcher::getSelectableInputNames() const {
+    juce::StringArray names;
+    auto devices = inputs.read();
+    for (const auto& device : *devices) {
+        if (!isOmnifyPort(device.name)) {
+            names.add(device.name);
+        }
+    }
+    return names;
+}
+
+std::optional<juce::MidiDeviceInfo> MidiDeviceWatcher::findInput(const juce::String& name) const { return find(inputs, name); }
+
+std::optional<juce::MidiDeviceInfo> MidiDeviceWatcher::findOutput(const juce::String& name) const { return find(outputs, name); }
+
+std::optional<juce::MidiDeviceInfo> MidiDeviceWatcher::find(DevicePublisher& devices, const juce::String& name) {
+    auto snapshot = devices.read();
+    for (const auto& device : *snapshot) {
+        if (device.name == name) {
+            return device;
+        }
+    }
+    return std::nullopt;
+}
+
+bool MidiDeviceWatcher::update(DevicePublisher& devices, DeviceList current) {
+    // Snapshots the message thread has moved past since the last pass are freed here
+    devices.reclaim();
+    if (current == *devices.latest()) {
+        return false;
+    }
+    devices.publish(std::make_shared<const DeviceList>(std::move(current)));
+    return true;
+}
+
+void MidiDeviceWatcher::run() {
+    while (!threadShouldExit()) {
+        bool inputsChanged = update(inputs, juce::MidiInput::getAvailableDevices());
+        bool outputsChanged = update(outputs, juce::MidiOutput::getAvailableDevices());
+        if (inputsChanged || outputsChanged) {
+            sendChangeMessage();
+        }
+        wait(POLL_INTERVAL_MS);
+    }
+}
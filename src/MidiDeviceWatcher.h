@@ -0,0 +1,57 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+#include <juce_events/juce_events.h>
+
+#include <memory>
+#include <optional>
+
+#include "SnapshotPublisher.h"
+
+/**
+ * Keeps an up to date list of the midi input and output devices, enumerated on a background thread so the message
+ * thread never waits on the OS (ALSA enumeration in particular can take tens of milliseconds).
+ *
+ * The thread re-enumerates whenever JUCE reports a device list change (where the OS sends hotplug notifications),
+ * and otherwise every POLL_INTERVAL_MS as a fallback. Each new list is published as an immutable snapshot through a
+ * SnapshotPublisher, with the watcher thread as its writer and the message thread as its one reader. Listeners get a
+ * change message on the message thread, only when a list actually changed.
+ *
+ * Use via juce::SharedResourcePointer<MidiDeviceWatcher>, so every panel and processor shares one thread.
+ */
+class MidiDeviceWatcher : public juce::ChangeBroadcaster, private juce::Thread {
+   public:
+    using DeviceList = juce::Array<juce::MidiDeviceInfo>;
+
+    static constexpr int POLL_INTERVAL_MS = 5000;
+
+    MidiDeviceWatcher();
+    ~MidiDeviceWatcher() override;
+
+    // Ports Omnify creates itself, rather than devices it opens
+    static bool isOmnifyPort(const juce::String& name) { return name.startsWith("Omnify"); }
+
+    // Message thread. The input devices a user can pick: everything but Omnify's own ports.
+    juce::StringArray getSelectableInputNames() const;
+
+    // Message thread. Look the device up by name in the current snapshot; empty until the first enumeration finishes.
+    std::optional<juce::MidiDeviceInfo> findInput(const juce::String& name) const;
+    std::optional<juce::MidiDeviceInfo> findOutput(const juce::String& name) const;
+
+   private:
+    using DevicePublisher = SnapshotPublisher<DeviceList>;
+
+    void run() override;
+
+    static std::optional<juce::MidiDeviceInfo> find(DevicePublisher& devices, const juce::String& name);
+
+    // Watcher thread: publishes the list if it changed, and returns whether it did
+    static bool update(DevicePublisher& devices, DeviceList current);
+
+    // Reading from a const method still pins a snapshot
+    mutable DevicePublisher inputs{std::make_shared<const DeviceList>()};
+    mutable DevicePublisher outputs{std::make_shared<const DeviceList>()};
+    juce::MidiDeviceListConnection deviceListConnection;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiDeviceWatcher)
+};
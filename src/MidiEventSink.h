@@ -0,0 +1,53 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <cstddef>
+
+// Fixed-capacity output for Omnify::handle.
+// Callers keep one on the stack (or as a member) and clear() it between messages, so producing
+// chord / strum events never touches the heap on the audio thread.
+class MidiEventSink {
+   public:
+    // A chord change is at most ChordNotes::MAX_NOTES note-offs followed by as many note-ons. A strum sweep is at
+    // most StrumPlate::MAX_ZONES note-ons, each possibly preceded by a note-off for a stolen or retriggered voice.
+    static constexpr size_t CAPACITY = 128;
+
+    MidiEventSink() = default;
+
+    // Returns false (and counts the drop) when the sink is already full.
+    // sampleOffset places the event relative to the message being handled; strum sweeps use negative offsets to fill
+    // in notes between the previous cc and this one.
+    bool add(const juce::MidiMessage& msg, int sampleOffset = 0) {
+        if (count >= CAPACITY) {
+            dropped++;
+            return false;
+        }
+        sampleOffsets[count] = sampleOffset;
+        events[count++] = msg;
+        return true;
+    }
+
+    void clear() { count = 0; }
+
+    bool isEmpty() const { return count == 0; }
+    size_t size() const { return count; }
+
+    // Total number of events rejected because the sink was full, never reset by clear()
+    size_t getDroppedCount() const { return dropped; }
+
+    const juce::MidiMessage* begin() const { return events.data(); }
+    const juce::MidiMessage* end() const { return events.data() + count; }
+
+    const juce::MidiMessage& operator[](size_t i) const { return events[i]; }
+    int sampleOffsetAt(size_t i) const { return sampleOffsets[i]; }
+
+   private:
+    std::array<juce::MidiMessage, CAPACITY> events;
+    std::array<int, CAPACITY> sampleOffsets{};
+    size_t count = 0;
+    size_t dropped = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiEventSink)
+};
@@ -0,0 +1,140 @@
+#include "MidiFloodGuard.h"
+
+#include <algorithm>
+#include <optional>
+
+MidiFloodGuard::CcKind MidiFloodGuard::kindOf(const juce::MidiMessage& msg, const CompiledSettings& s) {
+    switch (s.dispatch.forCc(msg.getControllerNumber(), msg.getControllerValue()).action) {
+        case DispatchTable::Action::CHORD_QUALITY:
+        case DispatchTable::Action::CHORD_QUALITY_RANGE:  // the engine ignores channels, so the supersede rule doesn't hold
+        case DispatchTable::Action::STOP:
+        case DispatchTable::Action::LATCH_FLIP:
+        case DispatchTable::Action::LATCH_ON:
+        case DispatchTable::Action::LATCH_OFF:
+            return CcKind::BUTTON;
+        case DispatchTable::Action::STRUM:
+            return CcKind::STRUM;
+        case DispatchTable::Action::CHORD:
+        case DispatchTable::Action::PASSTHROUGH:
+            break;
+    }
+    return isSequenceCc(msg.getControllerNumber()) ? CcKind::SEQUENCE : CcKind::COALESCE;
+}
+
+// Data entry (6, 38), data increment / decrement and parameter selects (96-101), and channel mode messages (120-127)
+bool MidiFloodGuard::isSequenceCc(int controller) {
+    return controller == 6 || controller == 38 || (controller >= 96 && controller <= 101) || controller >= 120;
+}
+
+bool MidiFloodGuard::filter(const juce::MidiBuffer& input, const CompiledSettings& s, juce::MidiBuffer& output, EngineStats& stats) {
+    // One event can't be redundant, and the budget can't be less than one
+    if (input.getNumEvents() <= 1) {
+        return false;
+    }
+
+    block++;
+
+    // First pass: an event is superseded when the next event on its channel is a coalescable cc for the same
+    // controller. Also finds each coalescable key's last event, which is kept even over budget.
+    struct ChannelTail {
+        int index = -1;
+        int controller = -1;  // -1 unless the event was a coalescable cc
+    };
+    std::array<ChannelTail, 16> tails{};
+    const auto tracked = std::min(static_cast<size_t>(input.getNumEvents()), TRACKED_EVENTS);
+    std::fill_n(superseded.begin(), (tracked + 63) / 64, 0);
+
+    int index = 0;
+    for (const auto metadata : input) {
+        auto msg = metadata.getMessage();
+        int channel = msg.getChannel();
+        if (channel > 0) {
+            int controller = msg.isController() && kindOf(msg, s) == CcKind::COALESCE ? msg.getControllerNumber() : -1;
+            if (controller >= 0) {
+                auto key = keyOf(msg);
+                lastIndex[key] = index;
+                lastIndexBlock[key] = block;
+            }
+            auto& tail = tails[static_cast<size_t>(channel - 1)];
+            if (controller >= 0 && tail.controller == controller && static_cast<size_t>(index) < tracked) {
+                superseded[static_cast<size_t>(tail.index) / 64] |= uint64_t{1} << (tail.index % 64);
+            }
+            tail = {index, controller};
+        }
+        index++;
+    }
+
+    // Second pass: output stays untouched until the first drop, at which point the events kept so far are copied over
+    bool dropping = false;
+    int kept = 0;
+    uint64_t coalesced = 0;
+    uint64_t overBudget = 0;
+    std::optional<int> lastStrumValue;
+    const int budget = s.maxEventsPerBlock > 0 ? s.maxEventsPerBlock : input.getNumEvents();
+
+    auto drop = [&]() {
+        if (!dropping) {
+            output.clear();
+            int toCopy = kept;
+            for (const auto m : input) {
+                if (toCopy-- <= 0) {
+                    break;
+                }
+                output.addEvent(m.data, m.numBytes, m.samplePosition);
+            }
+            dropping = true;
+        }
+    };
+
+    index = 0;
+    for (const auto metadata : input) {
+        auto msg = metadata.getMessage();
+        bool redundant = false;
+        bool droppable = false;
+
+        if (msg.isController()) {
+            switch (kindOf(msg, s)) {
+                case CcKind::STRUM: {
+                    int value = msg.getControllerValue();
+                    redundant = lastStrumValue && s.strumPlate.regionFor(*lastStrumValue) == s.strumPlate.regionFor(value);
+                    droppable = true;
+                    if (!redundant && kept < budget) {
+                        lastStrumValue = value;
+                    }
+                    break;
+                }
+                case CcKind::COALESCE: {
+                    auto key = keyOf(msg);
+                    redundant = static_cast<size_t>(index) < tracked &&
+                                (superseded[static_cast<size_t>(index) / 64] >> (index % 64) & 1) != 0;
+                    // Over budget a controller's last value in the block still gets through, and switches (sustain and
+                    // the like) always do, so nothing is left held down or at a stale value
+                    bool last = lastIndexBlock[key] == block && lastIndex[key] == index;
+                    droppable = !last && !isSwitchCc(msg.getControllerNumber());
+                    break;
+                }
+                case CcKind::BUTTON:
+                case CcKind::SEQUENCE:
+                    break;
+            }
+        }
+
+        if (redundant) {
+            drop();
+            coalesced++;
+        } else if (droppable && kept >= budget) {
+            drop();
+            overBudget++;
+        } else {
+            if (dropping) {
+                output.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
+            }
+            kept++;
+        }
+        index++;
+    }
+
+    stats.recordCcsCoalesced(coalesced);
+    stats.recordEventsOverBudget(overBudget);
+    return dropping;
+}
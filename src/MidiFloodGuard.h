@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <array>
+#include <cstdint>
+
+#include "DispatchTable.h"
+#include "EngineStats.h"
+
+/**
+ * The first stage of processMidiBlock: thins out floods of controller messages before they reach Omnify::handle, so a
+ * misbehaving controller costs a cheap scan instead of a full dispatch per message.
+ *
+ * Within a block:
+ *  - strum plate ccs are dropped while they stay in the same zone, or the same dead zone, as the previous one, so
+ *    every zone crossing still reaches handleStrum, and from there the sweep fill-in. The first strum cc of a block
+ *    always gets through, so touching the same zone again later still retriggers it once the cooldown allows.
+ *  - any other cc is dropped when the very next event on its channel is a cc for the same controller, since the later
+ *    value supersedes it. Anything else on the channel in between (a note, another controller) keeps it, so state
+ *    changes stay in order with the notes around them.
+ *  - some ccs are never dropped:
+ *     - the ones the dispatch table maps to buttons (latch, stop, chord quality), since each one is an action
+ *     - the chord quality range cc: dispatch ignores channels, so a note on another channel can come between two
+ *       range ccs and need the quality the first one selected
+ *     - parameter selects and data entry (RPN / NRPN sequences) and channel mode messages, whose meaning depends on
+ *       the messages around them
+ *  - past the settings' maxEventsPerBlock, strum and coalescable ccs are dropped outright, except for the last one
+ *    for each channel and controller, and switch controllers (64-69) which are never dropped over budget. Notes and
+ *    everything else always get through, so a flood can't leave a note stuck, whether by a missing note-off or by a
+ *    missing sustain release.
+ *
+ * Drops are counted in EngineStats. Never allocates as long as the output buffer has room for the input.
+ */
+class MidiFloodGuard {
+   public:
+    MidiFloodGuard() = default;
+
+    // Writes the surviving events of input to output and returns true if anything was dropped.
+    // Returns false, without touching output, when everything survives: input then goes through as is.
+    bool filter(const juce::MidiBuffer& input, const CompiledSettings& s, juce::MidiBuffer& output, EngineStats& stats);
+
+   private:
+    enum class CcKind : uint8_t { BUTTON, SEQUENCE, STRUM, COALESCE };
+
+    // Events past this many in a block are never coalesced, only held to the budget
+    static constexpr size_t TRACKED_EVENTS = 4096;
+
+    static CcKind kindOf(const juce::MidiMessage& msg, const CompiledSettings& s);
+    static bool isSequenceCc(int controller);
+    static bool isSwitchCc(int controller) { return controller >= 64 && controller <= 69; }  // sustain, portamento, ...
+    static size_t keyOf(const juce::MidiMessage& msg) {
+        return static_cast<size_t>(msg.getChannel() - 1) * 128 + static_cast<size_t>(msg.getControllerNumber());
+    }
+
+    static constexpr size_t KEYS = 16 * 128;  // channel x controller
+
+    // Per block: the events superseded by the next event on their channel, and each coalescable key's last event
+    std::array<uint64_t, TRACKED_EVENTS / 64> superseded{};
+    std::array<int, KEYS> lastIndex{};
+    std::array<uint32_t, KEYS> lastIndexBlock{};
+    uint32_t block = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiFloodGuard)
+};
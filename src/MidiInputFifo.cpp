@@ -0,0 +1,53 @@
+#include "MidiInputFifo.h"
+
+#include <algorithm>
+#include <cmath>
+
+void MidiInputFifo::reset(double newSampleRate) {
+    sampleRate = newSampleRate;
+    lastBlockMs = juce::Time::getMillisecondCounterHiRes();
+
+    IncomingMidiMessage discarded;
+    while (queue.pop(discarded)) {
+    }
+}
+
+void MidiInputFifo::handleIncomingMidiMessage(juce::MidiInput*, const juce::MidiMessage& message) {
+    auto size = message.getRawDataSize();
+    if (size > 3) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // juce stamps incoming messages with getMillisecondCounterHiRes() in seconds
+    IncomingMidiMessage msg;
+    msg.receivedAtMs = message.getTimeStamp() > 0.0 ? message.getTimeStamp() * 1000.0 : juce::Time::getMillisecondCounterHiRes();
+    msg.size = static_cast<uint8_t>(size);
+    std::copy(message.getRawData(), message.getRawData() + size, msg.bytes.begin());
+
+    if (!queue.push(msg)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MidiInputFifo::removeNextBlockOfMessages(juce::MidiBuffer& dest, int numSamples) {
+    auto now = juce::Time::getMillisecondCounterHiRes();
+    auto windowStartMs = lastBlockMs;
+    lastBlockMs = now;
+
+    if (numSamples <= 0) {
+        return;
+    }
+
+    // Usually the window since the last block is about a block long; when it's longer, scale it down to fit
+    double windowSamples = std::max((now - windowStartMs) * sampleRate / 1000.0, 1.0);
+    double scale = windowSamples > numSamples ? numSamples / windowSamples : 1.0;
+
+    // Only what's here now: anything arriving while this runs waits for the next block
+    IncomingMidiMessage msg;
+    for (int ready = queue.getNumReady(); ready > 0 && queue.pop(msg); ready--) {
+        double offset = (msg.receivedAtMs - windowStartMs) * sampleRate / 1000.0 * scale;
+        int position = std::clamp(static_cast<int>(std::lround(offset)), 0, numSamples - 1);
+        dest.addEvent(msg.bytes.data(), msg.size, position);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "SpscQueue.h"
+
+// A short (<= 3 byte) midi message from the input device, with its arrival time
+struct IncomingMidiMessage {
+    double receivedAtMs = 0.0;  // juce::Time::getMillisecondCounterHiRes() time
+    uint8_t size = 0;
+    std::array<uint8_t, 3> bytes{};
+};
+
+/**
+ * Carries midi from a juce::MidiInput to the audio thread without locks, in place of juce::MidiMessageCollector.
+ *
+ * The input thread pushes each message with its high resolution arrival time, and removeNextBlockOfMessages() maps
+ * the time since the previous block onto the block's samples, so events keep their relative spacing. If the audio
+ * thread falls behind, the backlog is squeezed into the block rather than left to pile up.
+ */
+class MidiInputFifo : public juce::MidiInputCallback {
+   public:
+    static constexpr int QUEUE_CAPACITY = 4096;
+
+    MidiInputFifo() = default;
+
+    // Call from prepareToPlay, before any blocks are removed
+    void reset(double sampleRate);
+
+    // Input thread. Messages longer than 3 bytes (sysex), and messages that don't fit, are dropped and counted.
+    void handleIncomingMidiMessage(juce::MidiInput* source, const juce::MidiMessage& message) override;
+
+    // Audio thread. Never blocks or allocates, as long as dest has room.
+    void removeNextBlockOfMessages(juce::MidiBuffer& dest, int numSamples);
+
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+   private:
+    SpscQueue<IncomingMidiMessage> queue{QUEUE_CAPACITY};
+    std::atomic<uint64_t> dropped{0};
+
+    // Audio thread only
+    double sampleRate = 44100.0;
+    double lastBlockMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiInputFifo)
+};
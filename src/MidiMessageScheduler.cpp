@@ -1,19 +1,179 @@
 #include "MidiMessageScheduler.h"
 
-void MidiMessageScheduler::setSampleRate(double sr) { sampleRate = sr; }
+#include <algorithm>
+#include <cmath>
+
+MidiMessageScheduler::MidiMessageScheduler() { prepare(sampleRate); }
+
+void MidiMessageScheduler::prepare(double sr, double maxDelayMs, size_t capacity) {
+    std::vector<ScheduledMidiMessage> pending;
+    pending.reserve(count);
+    for (int32_t head : slots) {
+        for (int32_t i = head; i >= 0; i = pool[static_cast<size_t>(i)].next) {
+            pending.push_back(pool[static_cast<size_t>(i)]);
+        }
+    }
+
+    sampleRate = sr;
+    auto maxDelaySamples = static_cast<int64_t>(std::ceil((maxDelayMs / 1000.0) * sampleRate));
+    slots.assign(static_cast<size_t>(maxDelaySamples / SLOT_SAMPLES + 2), -1);
+    pendingNoteOffs.assign(NOTE_OFF_KEYS, -1);
+    pool.assign(std::max(capacity, pending.size()), ScheduledMidiMessage{});
+    resetPool();
+    overflowCount = 0;
+
+    for (auto& msg : pending) {
+        int32_t index = freeList;
+        freeList = pool[static_cast<size_t>(index)].next;
+        pool[static_cast<size_t>(index)] = msg;
+        pool[static_cast<size_t>(index)].sendAtSample = 0;
+        insert(index);
+        if (msg.noteOffKey >= 0) {
+            pendingNoteOffs[static_cast<size_t>(msg.noteOffKey)] = index;
+        }
+        count++;
+    }
+}
+
+MidiMessageScheduler::Result MidiMessageScheduler::schedule(const juce::MidiMessage& msg, int64_t currentSample, double delayMs) {
+    auto size = msg.getRawDataSize();
+    if (size > 3) {
+        overflowCount++;
+        return Result::REJECTED;
+    }
 
-void MidiMessageScheduler::schedule(const juce::MidiMessage& msg, int64_t currentSample, double delayMs) {
     int64_t delaySamples = static_cast<int64_t>((delayMs / 1000.0) * sampleRate);
-    queue.push(ScheduledMidiMessage{.sendAtSample = currentSample + delaySamples, .message = msg});
+    auto key = noteOffKeyOf(msg);
+
+    // A note-off already pending for this note moves to the new time
+    if (key >= 0 && pendingNoteOffs[static_cast<size_t>(key)] >= 0) {
+        int32_t index = pendingNoteOffs[static_cast<size_t>(key)];
+        auto& entry = pool[static_cast<size_t>(index)];
+        unlink(index);
+        entry.sendAtSample = currentSample + delaySamples;
+        std::copy_n(msg.getRawData(), size, entry.bytes.begin());
+        insert(index);
+        return Result::REPLACED;
+    }
+
+    if (freeList < 0) {
+        overflowCount++;
+        return Result::REJECTED;
+    }
+
+    int32_t index = freeList;
+    auto& entry = pool[static_cast<size_t>(index)];
+    freeList = entry.next;
+
+    entry.sendAtSample = currentSample + delaySamples;
+    entry.noteOffKey = key;
+    entry.size = static_cast<uint8_t>(size);
+    std::copy_n(msg.getRawData(), size, entry.bytes.begin());
+
+    insert(index);
+    if (key >= 0) {
+        pendingNoteOffs[static_cast<size_t>(key)] = index;
+    }
+    count++;
+    return Result::SCHEDULED;
 }
 
 void MidiMessageScheduler::collectOverdueMessages(int64_t blockStartSample, int64_t blockEndSample, juce::MidiBuffer& buffer) {
-    while (!queue.empty() && queue.top().sendAtSample <= blockEndSample) {
-        int samplePosition = static_cast<int>(queue.top().sendAtSample - blockStartSample);
-        if (samplePosition < 0) samplePosition = 0;
-        buffer.addEvent(queue.top().message, samplePosition);
-        queue.pop();
+    if (count == 0) {
+        cursorTick = std::max(cursorTick, blockEndSample / SLOT_SAMPLES);
+        return;
     }
+
+    int64_t endTick = blockEndSample / SLOT_SAMPLES;
+    // After a long gap, visiting each slot once covers everything
+    int64_t firstTick = std::max(cursorTick, endTick - static_cast<int64_t>(slots.size()) + 1);
+
+    for (int64_t tick = firstTick; tick <= endTick; tick++) {
+        int32_t index = slots[static_cast<size_t>(tick % static_cast<int64_t>(slots.size()))];
+        while (index >= 0) {
+            auto& entry = pool[static_cast<size_t>(index)];
+            int32_t next = entry.next;
+            if (entry.sendAtSample <= blockEndSample) {
+                int samplePosition = static_cast<int>(std::max<int64_t>(entry.sendAtSample - blockStartSample, 0));
+                buffer.addEvent(entry.bytes.data(), entry.size, samplePosition);
+                unlink(index);
+                release(index);
+            }
+            index = next;
+        }
+    }
+
+    // The last tick may still hold messages due after this block, so it gets visited again next time
+    cursorTick = std::max(cursorTick, endTick);
 }
 
-void MidiMessageScheduler::clear() { queue = {}; }
+bool MidiMessageScheduler::cancelNoteOff(int channel, int note) {
+    int32_t index = pendingNoteOffs[noteOffKey(channel, note)];
+    if (index < 0) {
+        return false;
+    }
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void MidiMessageScheduler::clear() {
+    std::fill(slots.begin(), slots.end(), -1);
+    resetPool();
+}
+
+void MidiMessageScheduler::insert(int32_t index) {
+    auto& entry = pool[static_cast<size_t>(index)];
+    // Anything already overdue goes in the next slot to be collected
+    int64_t tick = std::max(entry.sendAtSample / SLOT_SAMPLES, cursorTick);
+    entry.slot = static_cast<int32_t>(tick % static_cast<int64_t>(slots.size()));
+    auto& head = slots[static_cast<size_t>(entry.slot)];
+    entry.prev = -1;
+    entry.next = head;
+    if (head >= 0) {
+        pool[static_cast<size_t>(head)].prev = index;
+    }
+    head = index;
+}
+
+void MidiMessageScheduler::unlink(int32_t index) {
+    auto& entry = pool[static_cast<size_t>(index)];
+    if (entry.prev >= 0) {
+        pool[static_cast<size_t>(entry.prev)].next = entry.next;
+    } else {
+        slots[static_cast<size_t>(entry.slot)] = entry.next;
+    }
+    if (entry.next >= 0) {
+        pool[static_cast<size_t>(entry.next)].prev = entry.prev;
+    }
+}
+
+// Returns an unlinked entry to the free list
+void MidiMessageScheduler::release(int32_t index) {
+    auto& entry = pool[static_cast<size_t>(index)];
+    if (entry.noteOffKey >= 0) {
+        pendingNoteOffs[static_cast<size_t>(entry.noteOffKey)] = -1;
+        entry.noteOffKey = -1;
+    }
+    entry.next = freeList;
+    freeList = index;
+    count--;
+}
+
+void MidiMessageScheduler::resetPool() {
+    for (size_t i = 0; i < pool.size(); i++) {
+        pool[i].next = i + 1 < pool.size() ? static_cast<int32_t>(i + 1) : -1;
+        pool[i].noteOffKey = -1;
+    }
+    std::fill(pendingNoteOffs.begin(), pendingNoteOffs.end(), -1);
+    freeList = pool.empty() ? -1 : 0;
+    count = 0;
+    cursorTick = 0;
+}
+
+int16_t MidiMessageScheduler::noteOffKeyOf(const juce::MidiMessage& msg) {
+    if (!msg.isNoteOff()) {  // includes note-ons with velocity 0
+        return -1;
+    }
+    return static_cast<int16_t>(noteOffKey(msg.getChannel(), msg.getNoteNumber()));
+}
@@ -1,36 +1,97 @@
 #pragma once
 
 #include <juce_audio_basics/juce_audio_basics.h>
-#include <juce_audio_devices/juce_audio_devices.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
-#include <queue>
 #include <vector>
 
+// A short (<= 3 byte) midi message waiting in MidiMessageScheduler's pool
 struct ScheduledMidiMessage {
-    int64_t sendAtSample;
-    juce::MidiMessage message;
-
-    bool operator>(const ScheduledMidiMessage& other) const { return sendAtSample > other.sendAtSample; }
+    int64_t sendAtSample = 0;
+    int32_t next = -1;  // next entry in the same wheel slot, or in the free list
+    int32_t prev = -1;  // previous entry in the same wheel slot, -1 for the slot's head
+    int32_t slot = -1;  // the wheel slot it's in
+    int16_t noteOffKey = -1;  // (channel - 1) * 128 + note for note-offs, which are indexed, -1 otherwise
+    uint8_t size = 0;
+    std::array<uint8_t, 3> bytes{};
 };
 
+/**
+ * Holds midi messages (strum note-offs) until the block they're due in.
+ *
+ * A hashed timing wheel over a fixed pool: schedule() is O(1), and collectOverdueMessages() only visits the wheel
+ * slots the block spans. Everything is allocated in prepare(), so the audio thread never allocates.
+ * When the pool is full schedule() rejects the message and counts an overflow.
+ *
+ * Note-offs are indexed by channel and note, so there's at most one pending per key: scheduling another one for a
+ * note that already has one moves the pending note-off to the new time instead of adding a second, which would cut
+ * the retriggered note short. Pending note-offs are therefore bounded by 16 x 128.
+ */
 class MidiMessageScheduler {
    public:
-    MidiMessageScheduler() = default;
+    static constexpr size_t DEFAULT_CAPACITY = 2048;
+    static constexpr double DEFAULT_MAX_DELAY_MS = 2000.0;
+
+    // Each wheel slot covers this many samples
+    static constexpr int64_t SLOT_SAMPLES = 32;
+
+    static constexpr size_t NOTE_OFF_KEYS = 16 * 128;
+
+    enum class Result {
+        SCHEDULED,
+        REPLACED,  // a note-off already pending for the same channel and note was moved to the new time
+        REJECTED,
+    };
 
-    void setSampleRate(double sampleRate);
+    MidiMessageScheduler();
 
-    void schedule(const juce::MidiMessage& msg, int64_t currentSample, double delayMs);
+    // Allocates, so call from prepareToPlay. maxDelayMs sizes the wheel: longer delays still work, but their slot is
+    // revisited once per revolution until they're due. Anything already pending is kept and comes out in the first
+    // block after prepare, so re-preparing never strands a note-off.
+    void prepare(double sampleRate, double maxDelayMs = DEFAULT_MAX_DELAY_MS, size_t capacity = DEFAULT_CAPACITY);
+
+    // Rejects the message (and counts an overflow) if the pool is full or the message is longer than 3 bytes
+    Result schedule(const juce::MidiMessage& msg, int64_t currentSample, double delayMs);
 
     void collectOverdueMessages(int64_t blockStartSample, int64_t blockEndSample, juce::MidiBuffer& buffer);
 
+    // Whether a note-off is pending for the note, i.e. whether it's still sounding. channel is 1-16.
+    bool isNoteOffPending(int channel, int note) const { return pendingNoteOffs[noteOffKey(channel, note)] >= 0; }
+
+    // Drops the note's pending note-off, for a caller that sends it itself. Returns false if there wasn't one.
+    bool cancelNoteOff(int channel, int note);
+
     void clear();
 
-    bool isEmpty() const { return queue.empty(); }
+    bool isEmpty() const { return count == 0; }
 
-    size_t size() const { return queue.size(); }
+    size_t size() const { return count; }
+
+    size_t capacity() const { return pool.size(); }
+
+    // Messages rejected by schedule() since prepare()
+    uint64_t getOverflowCount() const { return overflowCount; }
 
    private:
     double sampleRate = 44100.0;
-    std::priority_queue<ScheduledMidiMessage, std::vector<ScheduledMidiMessage>, std::greater<ScheduledMidiMessage>> queue;
+
+    std::vector<ScheduledMidiMessage> pool;
+    std::vector<int32_t> slots;  // head of each slot's list, -1 if empty
+    std::vector<int32_t> pendingNoteOffs;  // pool index of the pending note-off for each key, -1 if none
+    int32_t freeList = -1;
+    size_t count = 0;
+    uint64_t overflowCount = 0;
+
+    // Every tick before this one has been collected
+    int64_t cursorTick = 0;
+
+    void insert(int32_t index);
+    void unlink(int32_t index);
+    void release(int32_t index);
+    void resetPool();
+
+    static int16_t noteOffKeyOf(const juce::MidiMessage& msg);
+    static size_t noteOffKey(int channel, int note) { return static_cast<size_t>((channel - 1) * 128 + note); }
 };
@@ -0,0 +1,140 @@
+#include "MidiOutputThread.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// pending is a min-heap, so this orders by "later than"
+bool sendsLater(const OutgoingMidiMessage& a, const OutgoingMidiMessage& b) {
+    if (a.sendAtMs != b.sendAtMs) {
+        return a.sendAtMs > b.sendAtMs;
+    }
+    return a.sequence > b.sequence;
+}
+}  // namespace
+
+MidiOutputThread::MidiOutputThread() : juce::Thread("Omnify MIDI Output") { pending.reserve(static_cast<size_t>(QUEUE_CAPACITY)); }
+
+MidiOutputThread::~MidiOutputThread() { setOutput(nullptr); }
+
+void MidiOutputThread::enqueue(const juce::MidiBuffer& block, double blockStartMs, double sampleRate) {
+    if (!active.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    bool pushed = false;
+    for (const auto metadata : block) {
+        if (metadata.numBytes > 3) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        OutgoingMidiMessage msg;
+        msg.sendAtMs = blockStartMs + (metadata.samplePosition * 1000.0) / sampleRate;
+        msg.size = static_cast<uint8_t>(metadata.numBytes);
+        std::copy(metadata.data, metadata.data + metadata.numBytes, msg.bytes.begin());
+
+        if (queue.push(msg)) {
+            pushed = true;
+        } else {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Only the first block after the output thread ran out of work has to wake it
+    if (pushed && idle.exchange(false)) {
+        notify();
+    }
+}
+
+void MidiOutputThread::sendNow(const juce::MidiMessage& msg) {
+    const juce::ScopedLock sl(outputLock);
+    if (output) {
+        output->sendMessageNow(msg);
+        if (trace) {
+            trace->record(TraceRing::Kind::DEVICE_SEND, TraceRing::Track::DEVICE_OUTPUT, TraceRing::midiArg(msg.getRawData(), msg.getRawDataSize()));
+        }
+    }
+}
+
+void MidiOutputThread::setOutput(std::unique_ptr<juce::MidiOutput> newOutput) {
+    outputName = newOutput ? newOutput->getName() : juce::String();
+    bool hasDevice = newOutput != nullptr;
+
+    {
+        const juce::ScopedLock sl(outputLock);
+        std::swap(output, newOutput);
+    }
+    // newOutput now holds the previous device, which is closed here, outside the lock
+    newOutput.reset();
+
+    if (hasDevice) {
+        if (!isThreadRunning()) {
+            // An audio thread that saw active just before the last device closed may have queued a block after it was
+            // discarded. With the thread stopped, this thread is the only consumer, so those events go before they can
+            // reach the new device.
+            discardQueued();
+            active.store(true, std::memory_order_release);
+            startThread(juce::Thread::Priority::highest);
+        }
+    } else {
+        active.store(false, std::memory_order_release);
+        stopThread(1000);
+        discardQueued();
+    }
+}
+
+void MidiOutputThread::discardQueued() {
+    OutgoingMidiMessage discarded;
+    while (queue.pop(discarded)) {
+    }
+    pending.clear();
+}
+
+void MidiOutputThread::run() {
+    while (!threadShouldExit()) {
+        drainQueue();
+
+        auto now = juce::Time::getMillisecondCounterHiRes();
+        sendDueMessages(now);
+
+        if (pending.empty()) {
+            // Sleep until enqueue() wakes the thread. The queue is checked again after raising the flag, so a block
+            // enqueued in between isn't missed: its notify() makes wait() return straight away.
+            idle.store(true);
+            drainQueue();
+            if (pending.empty()) {
+                wait(-1);
+            }
+            idle.store(false);
+        } else {
+            // Each block is stamped later than the one before, so nothing enqueued meanwhile is due any sooner
+            wait(std::max(1, static_cast<int>(std::ceil(pending.front().sendAtMs - now))));
+        }
+    }
+}
+
+void MidiOutputThread::drainQueue() {
+    OutgoingMidiMessage msg;
+    while (pending.size() < static_cast<size_t>(QUEUE_CAPACITY) && queue.pop(msg)) {
+        msg.sequence = nextSequence++;
+        pending.push_back(msg);
+        std::push_heap(pending.begin(), pending.end(), sendsLater);
+    }
+}
+
+void MidiOutputThread::sendDueMessages(double now) {
+    const juce::ScopedLock sl(outputLock);
+    while (!pending.empty() && pending.front().sendAtMs <= now) {
+        std::pop_heap(pending.begin(), pending.end(), sendsLater);
+        const auto& msg = pending.back();
+        if (output) {
+            output->sendMessageNow(juce::MidiMessage(msg.bytes.data(), msg.size));
+            if (trace) {
+                trace->record(TraceRing::Kind::DEVICE_SEND, TraceRing::Track::DEVICE_OUTPUT, TraceRing::midiArg(msg.bytes.data(), msg.size),
+                              static_cast<int32_t>((now - msg.sendAtMs) * 1000.0));
+            }
+        }
+        pending.pop_back();
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <juce_audio_devices/juce_audio_devices.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "SpscQueue.h"
+#include "TraceRing.h"
+
+// A short (<= 3 byte) midi message on its way to the output device
+struct OutgoingMidiMessage {
+    double sendAtMs = 0.0;  // juce::Time::getMillisecondCounterHiRes() time
+    uint64_t sequence = 0;  // set by the output thread, keeps messages due at the same time in order
+    uint8_t size = 0;
+    std::array<uint8_t, 3> bytes{};
+};
+
+/**
+ * Sends midi to an output device from its own high priority thread, so the audio thread never calls into the OS midi
+ * API.
+ *
+ * The audio thread hands over each block through a lock-free queue, stamping every event with the wall clock time its
+ * sample position corresponds to. The output thread holds events until that time, so events keep their spacing
+ * within a block (at the cost of at most one block of latency) instead of going out in one burst.
+ *
+ * The thread only runs while there's a device, and sleeps until the next event is due, or until enqueue() wakes it
+ * when there's nothing to send.
+ */
+class MidiOutputThread : private juce::Thread {
+   public:
+    static constexpr int QUEUE_CAPACITY = 4096;
+
+    MidiOutputThread();
+    ~MidiOutputThread() override;
+
+    // Audio thread. blockStartMs is juce::Time::getMillisecondCounterHiRes() at the start of the block.
+    // Never allocates; events that don't fit, or are longer than 3 bytes, are dropped and counted. The first block
+    // after the output thread went idle wakes it with notify(), which briefly takes the thread's wait event mutex.
+    void enqueue(const juce::MidiBuffer& block, double blockStartMs, double sampleRate);
+
+    // Any thread but the audio thread: sends straight to the device, bypassing the queue. Takes the device lock.
+    void sendNow(const juce::MidiMessage& msg);
+
+    // Message thread. Pass nullptr to close the device and stop the thread.
+    void setOutput(std::unique_ptr<juce::MidiOutput> newOutput);
+
+    // Message thread: the name of the open device, or empty
+    juce::String getOutputName() const { return outputName; }
+
+    bool hasOutput() const { return active.load(std::memory_order_relaxed); }
+
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // Records every message sent to the device, with how late it went out. Set before opening a device.
+    void setTrace(TraceRing* ring) { trace = ring; }
+
+   private:
+    void run() override;
+
+    // Message thread, with the output thread stopped: throws away everything queued or pending
+    void discardQueued();
+
+    // Output thread: moves everything waiting in the queue into pending
+    void drainQueue();
+
+    // Output thread: sends everything in pending that's due by now
+    void sendDueMessages(double now);
+
+    SpscQueue<OutgoingMidiMessage> queue{QUEUE_CAPACITY};
+    std::atomic<bool> active{false};
+    std::atomic<bool> idle{false};  // the output thread is, or is about to be, waiting for enqueue()
+    std::atomic<uint64_t> dropped{0};
+
+    // Output thread only: a min-heap on (sendAtMs, sequence), never grown past QUEUE_CAPACITY
+    std::vector<OutgoingMidiMessage> pending;
+    uint64_t nextSequence = 0;
+
+    // Guards output between the message thread (setOutput), the output thread and sendNow() callers
+    juce::CriticalSection outputLock;
+    std::unique_ptr<juce::MidiOutput> output;
+    juce::String outputName;
+
+    TraceRing* trace = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE(MidiOutputThread)
+};
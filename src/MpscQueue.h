@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * A bounded, lock-free multiple producer / single consumer queue (Vyukov's bounded queue, with a single consumer).
+ *
+ * Each cell carries a sequence number saying whose turn it is, so producers only contend on one atomic index and
+ * never wait for each other: a producer that finds the queue full gets false back. Storage is allocated in the
+ * constructor, so push() and pop() never allocate or lock and are safe on the audio thread.
+ */
+template <typename T>
+class MpscQueue {
+   public:
+    // capacity is rounded up to a power of two
+    explicit MpscQueue(size_t capacity)
+        : mask(static_cast<size_t>(juce::nextPowerOfTwo(static_cast<int>(capacity))) - 1), cells(std::make_unique<Cell[]>(mask + 1)) {
+        for (size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Any thread. Returns false when the queue is full.
+    bool push(const T& item) {
+        auto pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& cell = cells[pos & mask];
+            auto sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.item = item;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. Returns false when the queue is empty.
+    bool pop(T& item) {
+        auto& cell = cells[dequeuePos & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            return false;
+        }
+        item = cell.item;
+        cell.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+        dequeuePos++;
+        return true;
+    }
+
+   private:
+    struct Cell {
+        std::atomic<size_t> sequence{0};
+        T item{};
+    };
+
+    const size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    std::atomic<size_t> enqueuePos{0};
+    size_t dequeuePos = 0;
+
+    static_assert(std::atomic<size_t>::is_always_lock_free);
+
+    JUCE_DECLARE_NON_COPYABLE(MpscQueue)
+};
@@ -3,42 +3,32 @@
 #include <juce_core/juce_core.h>
 
 #include <algorithm>
-#include <unordered_set>
+
 
 namespace {
-constexpr int STRUM_ZONE_COUNT = 13;
-constexpr int STRUM_DEAD_ZONE_SIZE = 2;
+// Consecutive strum ccs closer together than this are one sweep, and the zones between them get played
+constexpr double STRUM_SWEEP_MAX_GAP_MS = 50.0;
 
 // NOTE / IDEA:
 // use the inversions for up/down, but use root move direction as signal for up/down, eg C3 -> G3 means up, C3 -> G2 means down -- even for cases
 // where in the octave that doesn't happen
 
-// Returns zone index (0-12), or -1 if in a dead zone
-// Layout: [zone0][dead][zone1][dead]...[zone11][dead][zone12] (no dead after last zone)
-int getStrumZone(int ccValue) {
-    constexpr int deadZonesCount = STRUM_ZONE_COUNT - 1;
-    constexpr int zoneSize = (128 - deadZonesCount * STRUM_DEAD_ZONE_SIZE) / STRUM_ZONE_COUNT;
-    constexpr int unitSize = zoneSize + STRUM_DEAD_ZONE_SIZE;
-    constexpr int lastZoneStart = (STRUM_ZONE_COUNT - 1) * unitSize;
-
-    // Last zone has no dead zone after it
-    if (ccValue >= lastZoneStart) {
-        return STRUM_ZONE_COUNT - 1;
-    }
-
-    int zone = ccValue / unitSize;
-    int positionInUnit = ccValue % unitSize;
-    if (positionInUnit < zoneSize) {
-        return zone;
+// Copies the first count events of input to output
+void copyFirstEvents(const juce::MidiBuffer& input, int count, juce::MidiBuffer& output) {
+    for (const auto metadata : input) {
+        if (count-- <= 0) {
+            break;
+        }
+        output.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
     }
-
-    return -1;  // dead zone
 }
 }  // namespace
 
 Omnify::Omnify(MidiMessageScheduler& scheduler, std::shared_ptr<OmnifySettings> settings, std::shared_ptr<RealtimeParams> realtimeParams)
-    : scheduler(scheduler), realtimeParams(std::move(realtimeParams)) {
-    updateSettings(std::move(settings), true);
+    : scheduler(scheduler), settings(std::make_shared<const CompiledSettings>(*settings)), realtimeParams(std::move(realtimeParams)) {
+    guardedInput.ensureSize(GUARDED_INPUT_BYTES);
+    this->realtimeParams->strumGateTimeMs.store(settings->strumGateTimeMs);
+    this->realtimeParams->strumCooldownMs.store(settings->strumCooldownMs);
 }
 
 void Omnify::updateSettings(std::shared_ptr<OmnifySettings> newSettings, bool includeRealtime) {
@@ -46,111 +36,135 @@ void Omnify::updateSettings(std::shared_ptr<OmnifySettings> newSettings, bool in
         realtimeParams->strumGateTimeMs.store(newSettings->strumGateTimeMs);
         realtimeParams->strumCooldownMs.store(newSettings->strumCooldownMs);
     }
-    std::atomic_store(&settings, std::move(newSettings));
-}
-
-void Omnify::syncRealtimeSettings() {
-    auto s = std::atomic_load(&settings);
-    s->strumGateTimeMs = realtimeParams->strumGateTimeMs.load();
-    s->strumCooldownMs = realtimeParams->strumCooldownMs.load();
+    settings.publish(std::make_shared<const CompiledSettings>(*newSettings));
 }
 
 void Omnify::setSampleRate(double sr) { sampleRate = sr; }
 
-std::vector<juce::MidiMessage> Omnify::handle(const juce::MidiMessage& msg, int64_t currentSample) {
-    auto s = std::atomic_load(&settings);
-    if (auto r = handleChordQualityChange(msg, *s)) {
-        return *r;
-    }
-    if (auto r = handleStopButton(msg, *s)) {
-        return *r;
-    }
-    if (auto r = handleLatchButton(msg, *s)) {
-        return *r;
-    }
-    if (auto r = handleChordNoteOn(msg, *s)) {
-        return *r;
-    }
-    if (auto r = handleChordNoteOff(msg, *s)) {
-        return *r;
-    }
-    if (auto r = handleStrum(msg, *s, currentSample)) {
-        return *r;
-    }
-    return {msg};
+bool Omnify::handle(const juce::MidiMessage& msg, int64_t currentSample, MidiEventSink& out, size_t reader) {
+    auto s = readSettings(reader);
+    stats.recordEventIn();
+    traceTrack = reader == INPUT_THREAD_READER ? TraceRing::Track::MIDI_INPUT : TraceRing::Track::AUDIO;
+
+    auto outcome = dispatch(msg, *s, currentSample, out);
+    trace.record(TraceRing::Kind::DISPATCH, traceTrack, TraceRing::midiArg(msg.getRawData(), msg.getRawDataSize()),
+                 static_cast<int32_t>(outcome));
+    return outcome != TraceRing::Outcome::PASSTHROUGH;
 }
 
-std::optional<std::vector<juce::MidiMessage>> Omnify::handleChordQualityChange(const juce::MidiMessage& msg, const OmnifySettings& s) {
-    std::optional<ChordQuality> quality;
-
-    std::visit(
-        [&](auto&& style) {
-            using T = std::decay_t<decltype(style)>;
-            if constexpr (std::is_same_v<T, ButtonPerChordQuality>) {
-                if (msg.isNoteOn() && msg.getVelocity() > 0) {
-                    auto it = style.notes.find(msg.getNoteNumber());
-                    if (it != style.notes.end()) {
-                        quality = it->second;
-                    }
-                } else if (msg.isController()) {
-                    auto it = style.ccs.find(msg.getControllerNumber());
-                    if (it != style.ccs.end() && msg.getControllerValue() > 63) {
-                        quality = it->second;
-                    }
-                }
-            } else if constexpr (std::is_same_v<T, CCRangePerChordQuality>) {
-                if (msg.isController() && msg.getControllerNumber() == style.cc) {
-                    int idx = (msg.getControllerValue() * 9) / 128;
-                    quality = ALL_CHORD_QUALITIES[static_cast<size_t>(idx)];
+bool Omnify::processMidiBlock(const juce::MidiBuffer& blockInput, int64_t blockStartSample, int numSamples, juce::MidiBuffer& output) {
+    auto s = readSettings();
+
+    // Controller floods are thinned out before dispatch
+    bool guarded = floodGuard.filter(blockInput, *s, guardedInput, stats);
+    const auto& input = guarded ? guardedInput : blockInput;
+
+    // output stays untouched until something is consumed, at which point the passthrough so far is copied over
+    bool rewritten = false;
+    int index = 0;
+    auto rewrite = [&]() {
+        if (!rewritten) {
+            copyFirstEvents(input, index, output);
+            rewritten = true;
+        }
+    };
+
+    for (const auto metadata : input) {
+        try {
+            handledEvents.clear();
+            if (handle(metadata.getMessage(), blockStartSample + metadata.samplePosition, handledEvents)) {
+                rewrite();
+                for (size_t i = 0; i < handledEvents.size(); i++) {
+                    // Sweep fill-ins can land before this message, but not before the block
+                    int position = std::max(metadata.samplePosition + handledEvents.sampleOffsetAt(i), 0);
+                    output.addEvent(handledEvents[i], position);
                 }
+            } else if (rewritten) {
+                output.addEvent(metadata.data, metadata.numBytes, metadata.samplePosition);
             }
-        },
-        s.chordQualitySelectionStyle.value);
+        } catch (const std::exception& e) {
+            // The message is dropped, as if it had been consumed
+            rewrite();
+            DBG("processMidiBlock: exception in handle(): " << e.what());
+        }
+        index++;
+    }
 
-    if (quality) {
-        enqueuedChordQuality.store(*quality, std::memory_order_relaxed);
-        return std::vector<juce::MidiMessage>{};
+    if (guarded) {
+        rewrite();  // the guard dropped events, so the block's input isn't its output even if nothing was consumed
     }
-    return std::nullopt;
-}
 
-std::optional<std::vector<juce::MidiMessage>> Omnify::handleStopButton(const juce::MidiMessage& msg, const OmnifySettings& s) {
-    if (s.stopButton.handle(msg)) {
-        return stopNotesOfCurrentChord();
+    if (!scheduler.isEmpty()) {
+        rewrite();
+        int eventsBefore = output.getNumEvents();
+        scheduler.collectOverdueMessages(blockStartSample, blockStartSample + numSamples, output);
+        trace.record(TraceRing::Kind::COLLECT, TraceRing::Track::AUDIO, 0, output.getNumEvents() - eventsBefore);
     }
-    return std::nullopt;
+
+    stats.recordEventsOut(static_cast<uint64_t>(rewritten ? output.getNumEvents() : input.getNumEvents()));
+    stats.recordScheduler(scheduler.size(), scheduler.getOverflowCount());
+    return rewritten;
 }
 
-std::optional<std::vector<juce::MidiMessage>> Omnify::handleLatchButton(const juce::MidiMessage& msg, const OmnifySettings& s) {
-    auto action = s.latchButton.handle(msg);
-    if (!action) {
-        return std::nullopt;
+TraceRing::Outcome Omnify::dispatch(const juce::MidiMessage& msg, const CompiledSettings& s, int64_t currentSample, MidiEventSink& out) {
+    using Action = DispatchTable::Action;
+
+    const DispatchTable::Entry* entry = nullptr;
+    if (msg.isNoteOn() && msg.getVelocity() > 0) {
+        entry = &s.dispatch.forNoteOn(msg.getNoteNumber());
+    } else if (msg.isNoteOff() || msg.isNoteOn()) {  // a note-on with velocity 0 is a note-off
+        return handleChordNoteOff(msg, out) ? TraceRing::Outcome::CHORD_OFF : TraceRing::Outcome::PASSTHROUGH;
+    } else if (msg.isController()) {
+        entry = &s.dispatch.forCc(msg.getControllerNumber(), msg.getControllerValue());
+    } else {
+        return TraceRing::Outcome::PASSTHROUGH;
     }
 
-    switch (*action) {
-        case ButtonAction::ON:
-            latch = true;
-            break;
-        case ButtonAction::OFF:
-            latch = false;
-            break;
-        case ButtonAction::FLIP:
-            latch = !latch;
+    switch (entry->action) {
+        case Action::CHORD_QUALITY:
+            selectChordQuality(entry->quality);
+            return TraceRing::Outcome::CHORD_QUALITY;
+        case Action::CHORD_QUALITY_RANGE:
+            selectChordQuality(ALL_CHORD_QUALITIES[static_cast<size_t>((msg.getControllerValue() * 9) / 128)]);
+            return TraceRing::Outcome::CHORD_QUALITY;
+        case Action::STOP:
+            stopNotesOfCurrentChord(out);
+            return TraceRing::Outcome::STOP;
+        case Action::LATCH_FLIP:
+            setLatch(!latch, out);
+            return TraceRing::Outcome::LATCH;
+        case Action::LATCH_ON:
+            setLatch(true, out);
+            return TraceRing::Outcome::LATCH;
+        case Action::LATCH_OFF:
+            setLatch(false, out);
+            return TraceRing::Outcome::LATCH;
+        case Action::CHORD:
+            handleChordNoteOn(msg, s, out);
+            return TraceRing::Outcome::CHORD_ON;
+        case Action::STRUM:
+            handleStrum(msg, s, currentSample, out);
+            return TraceRing::Outcome::STRUM;
+        case Action::PASSTHROUGH:
             break;
     }
+    return TraceRing::Outcome::PASSTHROUGH;
+}
 
-    if (!latch) {
-        return stopNotesOfCurrentChord();
-    }
-    return std::vector<juce::MidiMessage>{};
+void Omnify::selectChordQuality(ChordQuality quality) {
+    enqueuedChordQuality.store(quality, std::memory_order_relaxed);
+    bumpDisplayVersion();
 }
 
-std::optional<std::vector<juce::MidiMessage>> Omnify::handleChordNoteOn(const juce::MidiMessage& msg, const OmnifySettings& s) {
-    if (!msg.isNoteOn() || msg.getVelocity() == 0) {
-        return std::nullopt;
+void Omnify::setLatch(bool on, MidiEventSink& out) {
+    latch = on;
+    if (!latch) {
+        stopNotesOfCurrentChord(out);
     }
+}
 
-    auto events = stopNotesOfCurrentChord();
+void Omnify::handleChordNoteOn(const juce::MidiMessage& msg, const CompiledSettings& s, MidiEventSink& out) {
+    stopNotesOfCurrentChord(out);
 
     auto quality = enqueuedChordQuality.load(std::memory_order_relaxed);
     currentChord = Chord{quality, msg.getNoteNumber()};
@@ -158,67 +172,35 @@ std::optional<std::vector<juce::MidiMessage>> Omnify::handleChordNoteOn(const ju
     lastPlayedChord = currentChord;
     lastVelocity = msg.getVelocity();
 
-    std::unordered_set<int> clampedNotes;
-
-    std::vector<int> chord;
-
-    switch (s.voicingModifier) {
-        case VoicingModifier::NONE:
-            chord = s.chordVoicingStyle->constructChord(currentChord->quality, currentChord->root);
-            break;
-        case VoicingModifier::FIXED:
-            chord = s.chordVoicingStyle->constructChord(currentChord->quality, 60 + (currentChord->root % 12));
-            break;
-        case VoicingModifier::SMOOTH:
-            auto normalizedRoot = 60 + (currentChord->root % 12);
-            auto middleOctaveNotes = s.chordVoicingStyle->constructChord(currentChord->quality, normalizedRoot);
-            std::vector<int> offsets;
-            offsets.reserve(middleOctaveNotes.size());
-            for (int x : middleOctaveNotes) {
-                offsets.push_back(x - normalizedRoot);
-            }
-            chord = smooth(offsets, currentChord->root);
-            break;
-    }
-
-    ChordNotes newChordNotes;
-    for (int note : chord) {
-        int clamped = clampNote(note);
-        if (clampedNotes.contains(clamped)) {
-            continue;
-        }
-        clampedNotes.insert(clamped);
+    const auto& chord = s.chordTable.get(currentChord->quality, currentChord->root);
 
-        events.push_back(juce::MidiMessage::noteOn(s.chordChannel, clamped, msg.getVelocity()));
+    playingChordNotes = ChordNotes{};
+    for (int8_t note : chord) {
+        out.add(juce::MidiMessage::noteOn(s.chordChannel, note, msg.getVelocity()));
 
-        if (newChordNotes.count < ChordNotes::MAX_NOTES) {
-            newChordNotes.notes[newChordNotes.count].note = static_cast<int8_t>(clamped);
-            newChordNotes.notes[newChordNotes.count].channel = static_cast<int8_t>(s.chordChannel);
-            newChordNotes.count++;
-        }
+        playingChordNotes.notes[playingChordNotes.count].note = note;
+        playingChordNotes.notes[playingChordNotes.count].channel = static_cast<int8_t>(s.chordChannel);
+        playingChordNotes.count++;
     }
-    chordNotes.store(newChordNotes, std::memory_order_relaxed);
-
-    return events;
+    chordNotes.store(playingChordNotes);
+    bumpDisplayVersion();
 }
 
-std::optional<std::vector<juce::MidiMessage>> Omnify::handleChordNoteOff(const juce::MidiMessage& msg, const OmnifySettings& s) {
-    bool isNoteOff = msg.isNoteOff() || (msg.isNoteOn() && msg.getVelocity() == 0);
-    if (!isNoteOff) {
-        return std::nullopt;
-    }
-
+bool Omnify::handleChordNoteOff(const juce::MidiMessage& msg, MidiEventSink& out) {
     if (currentChord && currentChord->root == msg.getNoteNumber() && !latch) {
-        return stopNotesOfCurrentChord();
+        stopNotesOfCurrentChord(out);
+        return true;
     }
 
-    return std::nullopt;
+    return false;
 }
 
-std::optional<std::vector<juce::MidiMessage>> Omnify::handleStrum(const juce::MidiMessage& msg, const OmnifySettings& s, int64_t currentSample) {
-    if (!(msg.isController() && msg.getControllerNumber() == s.strumPlateCC)) {
-        return std::nullopt;
-    }
+void Omnify::handleStrum(const juce::MidiMessage& msg, const CompiledSettings& s, int64_t currentSample, MidiEventSink& out) {
+    int ccValue = msg.getControllerValue();
+    auto previousCcValue = lastStrumCcValue;
+    auto previousCcSample = lastStrumCcSample;
+    lastStrumCcValue = ccValue;
+    lastStrumCcSample = currentSample;
 
     const Chord* chordToStrum = nullptr;
     if (currentChord) {
@@ -226,92 +208,117 @@ std::optional<std::vector<juce::MidiMessage>> Omnify::handleStrum(const juce::Mi
     } else if (lastPlayedChord) {
         chordToStrum = &*lastPlayedChord;
     } else {
-        return std::vector<juce::MidiMessage>{};
+        return;
     }
 
-    auto cooldownSamples = static_cast<int64_t>((realtimeParams->strumCooldownMs.load() / 1000.0) * sampleRate);
-    bool cooldownReady = currentSample >= lastStrumSample + cooldownSamples;
+    auto rootToUse = (chordToStrum->root % 12) + 60;
+    const auto& strumChord = s.strumTable->get(chordToStrum->quality, rootToUse);
+
+    // A fast sweep skips zones between ccs. Play the ones it crossed, each where the sweep would have entered it
+    // assuming it moved at a steady speed between the two ccs. A longer gap is a new touch, not a sweep.
+    auto sweepGapSamples = static_cast<int64_t>((STRUM_SWEEP_MAX_GAP_MS / 1000.0) * sampleRate);
+    if (previousCcValue && currentSample - previousCcSample <= sweepGapSamples) {
+        auto crossing = s.strumPlate.zonesCrossed(*previousCcValue, ccValue);
+        auto elapsed = currentSample - previousCcSample;
+        for (int i = 0; i < crossing.count; i++) {
+            int zone = crossing.first + i * crossing.step;
+            int entry = s.strumPlate.entryValue(zone, crossing.step > 0);
+            auto sampleOffset = -elapsed * (ccValue - entry) / (ccValue - *previousCcValue);
+            strumZone(zone, strumChord, s, currentSample + sampleOffset, static_cast<int>(sampleOffset), out);
+        }
+    }
 
-    int strumPlateZone = getStrumZone(msg.getControllerValue());
+    int strumPlateZone = s.strumPlate.zoneFor(ccValue);
     if (strumPlateZone < 0) {
-        return std::vector<juce::MidiMessage>{};  // in dead zone
+        stats.recordStrumSuppressedByDeadZone();
+        return;  // in dead zone
     }
 
-    if (lastStrumZone != strumPlateZone || cooldownReady) {
-        auto rootToUse = (chordToStrum->root % 12) + 60;
-        auto strumChord = s.strumVoicingStyle->constructChord(chordToStrum->quality, rootToUse);
-        int noteToPlay = strumChord[static_cast<size_t>(strumPlateZone)];
-
-        auto noteOn = juce::MidiMessage::noteOn(s.strumChannel, noteToPlay, lastVelocity);
+    strumZone(strumPlateZone, strumChord, s, currentSample, 0, out);
+}
 
-        scheduler.schedule(juce::MidiMessage::noteOff(s.strumChannel, noteToPlay), currentSample,
-                           static_cast<double>(realtimeParams->strumGateTimeMs.load()));
+void Omnify::strumZone(int zone, const StrumVoicing& strumChord, const OmnifySettings& s, int64_t sample, int sampleOffset, MidiEventSink& out) {
+    auto cooldownSamples = static_cast<int64_t>((realtimeParams->strumCooldownMs.load() / 1000.0) * sampleRate);
+    bool cooldownReady = sample >= lastStrumSample + cooldownSamples;
+    if (lastStrumZone == zone && !cooldownReady) {
+        stats.recordStrumSuppressedByCooldown();
+        return;
+    }
 
-        lastStrumSample = currentSample;
-        lastStrumZone = strumPlateZone;
+    if (zone >= strumChord.count) {
+        return;
+    }
+    int noteToPlay = strumChord.notes[static_cast<size_t>(zone)];
 
-        return std::vector<juce::MidiMessage>{noteOn};
+    if (s.maxStrumVoices > 0 && !scheduler.isNoteOffPending(s.strumChannel, noteToPlay)) {
+        makeRoomForStrumVoice(s, sampleOffset, out);
     }
 
-    return std::vector<juce::MidiMessage>{};
-}
+    auto noteOff = juce::MidiMessage::noteOff(s.strumChannel, noteToPlay);
+    auto gateMs = static_cast<double>(realtimeParams->strumGateTimeMs.load());
+    auto result = scheduler.schedule(noteOff, sample, gateMs);
+    trace.record(TraceRing::Kind::SCHEDULE, traceTrack, TraceRing::midiArg(noteOff.getRawData(), noteOff.getRawDataSize()),
+                 result != MidiMessageScheduler::Result::REJECTED ? static_cast<int32_t>(gateMs / 1000.0 * sampleRate) : -1);
 
-std::vector<juce::MidiMessage> Omnify::stopNotesOfCurrentChord() {
-    currentChord = std::nullopt;
-    currentRoot.store(-1, std::memory_order_relaxed);
+    // With the scheduler full there'd be nothing to end the note, so it isn't played
+    if (result == MidiMessageScheduler::Result::REJECTED) {
+        return;
+    }
 
-    auto notes = chordNotes.load(std::memory_order_relaxed);
-    std::vector<juce::MidiMessage> events;
-    events.reserve(notes.count);
-    for (uint8_t i = 0; i < notes.count; i++) {
-        events.push_back(juce::MidiMessage::noteOff(notes.notes[i].channel, notes.notes[i].note));
+    // Still sounding from an earlier strum: its pending note-off now ends this one instead, so end the earlier one here
+    // and every note-on keeps its own note-off
+    if (result == MidiMessageScheduler::Result::REPLACED) {
+        out.add(noteOff, sampleOffset);
     }
-    chordNotes.store(ChordNotes{}, std::memory_order_relaxed);
-    return events;
+    out.add(juce::MidiMessage::noteOn(s.strumChannel, noteToPlay, lastVelocity), sampleOffset);
+    strumVoices[static_cast<size_t>(noteToPlay)] = {sample, lastVelocity};
+
+    lastStrumSample = sample;
+    lastStrumZone = zone;
 }
 
-int Omnify::clampNote(int note) { return std::clamp(note, 0, 127); }
+void Omnify::makeRoomForStrumVoice(const OmnifySettings& s, int sampleOffset, MidiEventSink& out) {
+    // A strum note is sounding for as long as its note-off is pending
+    for (;;) {
+        int sounding = 0;
+        int victim = -1;
+        for (int note = 0; note < 128; note++) {
+            if (!scheduler.isNoteOffPending(s.strumChannel, note)) {
+                continue;
+            }
+            sounding++;
 
-std::vector<int> Omnify::smooth(std::vector<int> offsets, int root) {
-    std::sort(offsets.begin(), offsets.end());
-    auto octave = root / 12;
-    std::vector<int> notes;
-    notes.reserve(offsets.size());
+            if (victim < 0) {
+                victim = note;
+                continue;
+            }
+            const auto& candidate = strumVoices[static_cast<size_t>(note)];
+            const auto& current = strumVoices[static_cast<size_t>(victim)];
+            bool quieter = candidate.velocity < current.velocity;
+            bool older = candidate.startSample < current.startSample;
+            if (s.strumVoiceStealing == VoiceStealing::QUIETEST ? (quieter || (candidate.velocity == current.velocity && older)) : older) {
+                victim = note;
+            }
+        }
 
-    std::vector<int> inversionOffsets(offsets.size(), 0);
+        if (sounding < s.maxStrumVoices || victim < 0) {
+            return;
+        }
 
-    switch (octave) {
-        case 2:
-            inversionOffsets[inversionOffsets.size() - 3] = -12;
-            inversionOffsets[inversionOffsets.size() - 2] = -12;
-            inversionOffsets[inversionOffsets.size() - 1] = -12;
-            break;
-        case 3:
-            inversionOffsets[inversionOffsets.size() - 2] = -12;
-            inversionOffsets[inversionOffsets.size() - 1] = -12;
-            break;
-        case 4:
-            inversionOffsets[inversionOffsets.size() - 1] = -12;
-            break;
-        // case 5: middle octave, do nothing
-        case 6:
-            inversionOffsets[0] = 12;
-            break;
-        case 7:
-            inversionOffsets[0] = 12;
-            inversionOffsets[1] = 12;
-            break;
-        case 8:
-            inversionOffsets[0] = 12;
-            inversionOffsets[1] = 12;
-            inversionOffsets[2] = 12;
-        default:
-            break;
+        scheduler.cancelNoteOff(s.strumChannel, victim);
+        out.add(juce::MidiMessage::noteOff(s.strumChannel, victim), sampleOffset);
+        stats.recordStrumVoiceStolen();
     }
+}
 
-    for (size_t i = 0; i < offsets.size(); i++) {
-        notes.push_back(60 + (root % 12) + offsets[i] + inversionOffsets[i]);
-    }
+void Omnify::stopNotesOfCurrentChord(MidiEventSink& out) {
+    currentChord = std::nullopt;
+    currentRoot.store(-1, std::memory_order_relaxed);
 
-    return notes;
-}
\ No newline at end of file
+    for (uint8_t i = 0; i < playingChordNotes.count; i++) {
+        out.add(juce::MidiMessage::noteOff(playingChordNotes.notes[i].channel, playingChordNotes.notes[i].note));
+    }
+    playingChordNotes = ChordNotes{};
+    chordNotes.store(playingChordNotes);
+    bumpDisplayVersion();
+}
@@ -2,12 +2,19 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 
+#include <array>
 #include <atomic>
 #include <memory>
 #include <optional>
-#include <vector>
 
+#include "DispatchTable.h"
+#include "EngineStats.h"
+#include "MidiEventSink.h"
+#include "MidiFloodGuard.h"
 #include "MidiMessageScheduler.h"
+#include "SeqLock.h"
+#include "SnapshotPublisher.h"
+#include "TraceRing.h"
 #include "datamodel/ChordQuality.h"
 #include "datamodel/MidiButton.h"
 #include "datamodel/OmnifySettings.h"
@@ -15,6 +22,8 @@
 struct RealtimeParams {
     std::atomic<int> strumGateTimeMs{500};
     std::atomic<int> strumCooldownMs{300};
+
+    static_assert(std::atomic<int>::is_always_lock_free);
 };
 
 struct NoteInfo {
@@ -23,7 +32,7 @@ struct NoteInfo {
 };
 
 struct ChordNotes {
-    static constexpr int MAX_NOTES = 8;
+    static constexpr int MAX_NOTES = static_cast<int>(ChordVoicing::MAX_NOTES);
     NoteInfo notes[MAX_NOTES] = {};
     uint8_t count = 0;
 };
@@ -31,47 +40,114 @@ static_assert(std::is_trivially_copyable_v<ChordNotes>);
 
 class Omnify {
    public:
+    // Settings reader slots: handle() may run on the audio thread and, in direct mode, on the midi input thread
+    static constexpr size_t AUDIO_THREAD_READER = 0;
+    static constexpr size_t INPUT_THREAD_READER = 1;
+    using SettingsPublisher = SnapshotPublisher<CompiledSettings, 2>;
+
     Omnify(MidiMessageScheduler& scheduler, std::shared_ptr<OmnifySettings> settings, std::shared_ptr<RealtimeParams> realtimeParams);
 
     void setSampleRate(double sr);
-    std::vector<juce::MidiMessage> handle(const juce::MidiMessage& msg, int64_t currentSample);
 
+    // Writes any resulting events into `out` and returns true if the message was consumed.
+    // Returns false, without touching `out`, for messages Omnify doesn't use; the caller passes those through.
+    // Never allocates, so it's safe to call from the audio thread. Not reentrant: callers on different threads must
+    // serialize calls and pass their own reader.
+    bool handle(const juce::MidiMessage& msg, int64_t currentSample, MidiEventSink& out, size_t reader = AUDIO_THREAD_READER);
+
+    // Runs a block of input through the flood guard and then handle(), passing unhandled messages through at their
+    // original position, then drains the scheduler for the block. processBlock and the headless tools all go through
+    // here. Returns false, without touching output, when nothing was dropped or consumed and nothing is scheduled:
+    // input is then already the block's output and callers can swap it through instead of copying.
+    bool processMidiBlock(const juce::MidiBuffer& input, int64_t blockStartSample, int numSamples, juce::MidiBuffer& output);
+
+    // Message thread only. Compiles the settings' dispatch table before publishing them.
     void updateSettings(std::shared_ptr<OmnifySettings> newSettings, bool includeRealtime = false);
-    void syncRealtimeSettings();
+    void reclaimSettings() { settings.reclaim(); }
+
+    // Pins the current settings until the scope ends. handle() nests inside it when given the same reader, so a whole
+    // block sees one consistent snapshot.
+    SettingsPublisher::ReadScope readSettings(size_t reader = AUDIO_THREAD_READER) { return settings.read(reader); }
 
     // Thread-safe getters for UI display
     ChordQuality getEnqueuedChordQuality() const { return enqueuedChordQuality.load(std::memory_order_relaxed); }
-    ChordNotes getChordNotes() const { return chordNotes.load(std::memory_order_relaxed); }
+    ChordNotes getChordNotes() const { return chordNotes.load(); }
     int getCurrentRoot() const { return currentRoot.load(std::memory_order_relaxed); }  // -1 if no chord
 
+    // Changes whenever anything the getters above return does, so the editor can skip its update when it hasn't.
+    // Read it before the getters: if it's moved on since, the next read will catch up.
+    uint64_t getDisplayVersion() const { return displayVersion.load(std::memory_order_acquire); }
+
     // Thread-safe setter for UI input
-    void setEnqueuedChordQuality(ChordQuality quality) { enqueuedChordQuality.store(quality, std::memory_order_relaxed); }
+    void setEnqueuedChordQuality(ChordQuality quality) {
+        enqueuedChordQuality.store(quality, std::memory_order_relaxed);
+        bumpDisplayVersion();
+    }
+
+    // Hot path counters. handle() and processMidiBlock() count events, strums and the scheduler; whoever drives the
+    // engine records block times and, outside processMidiBlock(), events sent.
+    EngineStats& getStats() { return stats; }
+    const EngineStats& getStats() const { return stats; }
+
+    // Engine event timeline. handle() and processMidiBlock() record dispatches, scheduling and collection; whoever
+    // drives the engine records block boundaries and device sends.
+    TraceRing& getTrace() { return trace; }
 
    private:
     MidiMessageScheduler& scheduler;
-    std::shared_ptr<OmnifySettings> settings;  // use std::atomic_load/store for thread safety
+    SettingsPublisher settings;
     std::shared_ptr<RealtimeParams> realtimeParams;
     double sampleRate = 44100.0;
 
     // State
     std::atomic<ChordQuality> enqueuedChordQuality{ChordQuality::MAJOR};
-    std::atomic<ChordNotes> chordNotes;
+    ChordNotes playingChordNotes;
+    SeqLock<ChordNotes> chordNotes;  // playingChordNotes, published for the editor
     std::atomic<int> currentRoot{-1};  // -1 means no chord active
+    std::atomic<uint64_t> displayVersion{0};
     std::optional<Chord> currentChord;
     std::optional<Chord> lastPlayedChord;
     juce::uint8 lastVelocity = 100;
     int64_t lastStrumSample = 0;
     std::optional<int> lastStrumZone;
+    struct StrumVoice {
+        int64_t startSample = 0;
+        juce::uint8 velocity = 0;
+    };
+    std::array<StrumVoice, 128> strumVoices{};  // by note, for voice stealing; only current while its note-off is pending
+    std::optional<int> lastStrumCcValue;  // the previous strum cc, for filling in the zones a sweep skipped
+    int64_t lastStrumCcSample = 0;
     bool latch = false;
+    MidiEventSink handledEvents;
+    MidiFloodGuard floodGuard;
+    static constexpr int GUARDED_INPUT_BYTES = 32768;  // a few thousand short messages
+    juce::MidiBuffer guardedInput;  // the flood guard's output, preallocated so a busy block doesn't allocate
+    EngineStats stats;
+    TraceRing trace;
+    TraceRing::Track traceTrack = TraceRing::Track::AUDIO;  // the caller of the current handle()
+
+    // Everything shared with the editor or other threads must be readable without the audio thread ever waiting
+    static_assert(std::atomic<ChordQuality>::is_always_lock_free);
+    static_assert(std::atomic<int>::is_always_lock_free);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    // After the display state's stores, so a reader that sees the new version sees them too
+    void bumpDisplayVersion() { displayVersion.fetch_add(1, std::memory_order_release); }
+
+    // Looks the message up in the dispatch table and carries out its action
+    TraceRing::Outcome dispatch(const juce::MidiMessage& msg, const CompiledSettings& s, int64_t currentSample, MidiEventSink& out);
+
+    void selectChordQuality(ChordQuality quality);
+    void setLatch(bool on, MidiEventSink& out);
+    void handleChordNoteOn(const juce::MidiMessage& msg, const CompiledSettings& s, MidiEventSink& out);
+    // Returns true if the note-off released the current chord
+    bool handleChordNoteOff(const juce::MidiMessage& msg, MidiEventSink& out);
+    void handleStrum(const juce::MidiMessage& msg, const CompiledSettings& s, int64_t currentSample, MidiEventSink& out);
+    // Plays zone's note at sample (sampleOffset from the message being handled), unless the cooldown holds it back
+    void strumZone(int zone, const StrumVoicing& strumChord, const OmnifySettings& s, int64_t sample, int sampleOffset, MidiEventSink& out);
 
-    std::optional<std::vector<juce::MidiMessage>> handleChordQualityChange(const juce::MidiMessage& msg, const OmnifySettings& s);
-    std::optional<std::vector<juce::MidiMessage>> handleStopButton(const juce::MidiMessage& msg, const OmnifySettings& s);
-    std::optional<std::vector<juce::MidiMessage>> handleLatchButton(const juce::MidiMessage& msg, const OmnifySettings& s);
-    std::optional<std::vector<juce::MidiMessage>> handleChordNoteOn(const juce::MidiMessage& msg, const OmnifySettings& s);
-    std::optional<std::vector<juce::MidiMessage>> handleChordNoteOff(const juce::MidiMessage& msg, const OmnifySettings& s);
-    std::optional<std::vector<juce::MidiMessage>> handleStrum(const juce::MidiMessage& msg, const OmnifySettings& s, int64_t currentSample);
+    // Cuts off sounding strum notes, per the settings' stealing order, until a new one fits under maxStrumVoices
+    void makeRoomForStrumVoice(const OmnifySettings& s, int sampleOffset, MidiEventSink& out);
 
-    std::vector<juce::MidiMessage> stopNotesOfCurrentChord();
-    static int clampNote(int note);
-    static std::vector<int> smooth(std::vector<int> offsets, int root);
+    void stopNotesOfCurrentChord(MidiEventSink& out);
 };
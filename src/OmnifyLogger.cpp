@@ -1,10 +1,13 @@
 #include "OmnifyLogger.h"
 
+#include <cstring>
+#include <string>
+
 #if JUCE_MAC || JUCE_LINUX
 #include <unistd.h>  // for confstr
 #endif
 
-OmnifyLogger::OmnifyLogger() {
+OmnifyLogger::OmnifyLogger() : juce::Thread("Omnify Logger") {
     auto systemTempDir = getSystemTempDir();
 
     // Create a unique session directory: omnify-<uuid>/
@@ -12,22 +15,103 @@ OmnifyLogger::OmnifyLogger() {
     sessionTempDir = juce::File(systemTempDir).getChildFile("omnify-" + uuid);
     sessionTempDir.createDirectory();
 
-    // Create logger in the session directory
+    // Create log file in the session directory
     auto logFile = sessionTempDir.getChildFile("omnify.log");
-    logger = std::make_unique<juce::FileLogger>(logFile, "Omnify Debug Log");
+    logStream = std::make_unique<juce::FileOutputStream>(logFile);
+    if (!logStream->openedOk()) {
+        logStream.reset();
+    }
+    log("Omnify Debug Log, " + juce::Time::getCurrentTime().toString(true, true));
+
+    startThread(juce::Thread::Priority::low);
 
     // Set as current logger so Logger::writeToLog works
-    juce::Logger::setCurrentLogger(logger.get());
+    juce::Logger::setCurrentLogger(this);
 }
 
 OmnifyLogger::~OmnifyLogger() {
     juce::Logger::setCurrentLogger(nullptr);
+    signalThreadShouldExit();
+    notify();
+    stopThread(2000);
+
+    // With the writer stopped, this thread is the only consumer
+    writePending();
 }
 
 void OmnifyLogger::log(const juce::String& message) {
-    if (logger) {
-        logger->logMessage(message);
+    Record record;
+    record.timeMs = juce::Time::currentTimeMillis();
+
+    // Truncate on a UTF-8 character boundary
+    auto* utf8 = message.toRawUTF8();
+    auto length = std::strlen(utf8);
+    if (length > MAX_MESSAGE_BYTES) {
+        length = MAX_MESSAGE_BYTES - 3;
+        while (length > 0 && (static_cast<uint8_t>(utf8[length]) & 0xC0) == 0x80) {
+            length--;
+        }
+        std::memcpy(record.text.data() + length, "...", 3);
+        record.textLength = static_cast<uint16_t>(length + 3);
+    } else {
+        record.textLength = static_cast<uint16_t>(length);
+    }
+    std::memcpy(record.text.data(), utf8, length);
+
+    enqueue(record);
+    notify();
+}
+
+void OmnifyLogger::enqueue(const Record& record) {
+    if (!queue.push(record)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void OmnifyLogger::run() {
+    while (!threadShouldExit()) {
+        wait(WRITE_INTERVAL_MS);
+        writePending();
+    }
+}
+
+void OmnifyLogger::writePending() {
+    juce::String batch;
+    Record record;
+    while (queue.pop(record)) {
+        batch << juce::Time(record.timeMs).formatted("%H:%M:%S") << "." << juce::String(record.timeMs % 1000).paddedLeft('0', 3) << " "
+              << format(record) << juce::newLine;
+    }
+
+    auto droppedNow = dropped.load(std::memory_order_relaxed);
+    if (droppedNow != droppedReported) {
+        batch << "(" << juce::String(droppedNow - droppedReported) << " log messages dropped, the queue was full)" << juce::newLine;
+        droppedReported = droppedNow;
+    }
+
+    if (batch.isNotEmpty() && logStream) {
+        logStream->writeText(batch, false, false, nullptr);
+        logStream->flush();
+    }
+}
+
+juce::String OmnifyLogger::format(const Record& record) {
+    if (record.format == nullptr) {
+        return juce::String::fromUTF8(record.text.data(), static_cast<int>(record.textLength));
+    }
+
+    std::string formatted;
+    size_t nextArg = 0;
+    for (const char* c = record.format; *c != 0; c++) {
+        if (c[0] == '{' && c[1] == '}' && nextArg < record.numArgs) {
+            const auto& arg = record.args[nextArg++];
+            formatted += (arg.isInteger ? juce::String(arg.integer) : juce::String(arg.real)).toStdString();
+            c++;
+        } else {
+            formatted += *c;
+        }
     }
+    return juce::String::fromUTF8(formatted.data(), static_cast<int>(formatted.size()));
 }
 
 juce::String OmnifyLogger::getSystemTempDir() {
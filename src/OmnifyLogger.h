@@ -2,27 +2,100 @@
 
 #include <juce_core/juce_core.h>
 
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "MpscQueue.h"
+
 /**
  * Shared logging and temp directory for Omnify plugin.
  * Creates a unique session directory under the system temp dir.
  *
+ * Logging never touches the disk on the calling thread: records go through a lock-free queue to a background thread,
+ * which formats them and appends them to the log file in batches. When the queue is full records are dropped, and
+ * the writer notes how many.
+ *
  * Use via juce::SharedResourcePointer<OmnifyLogger> to ensure proper cleanup.
  */
-class OmnifyLogger {
+class OmnifyLogger : public juce::Logger, private juce::Thread {
    public:
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+    static constexpr size_t MAX_MESSAGE_BYTES = 480;  // longer messages are truncated
+    static constexpr size_t MAX_RT_ARGS = 4;
+    static constexpr int WRITE_INTERVAL_MS = 50;
+
+    // Also sets itself as juce::Logger::currentLogger, so Logger::writeToLog() works too
     OmnifyLogger();
-    ~OmnifyLogger();
+    ~OmnifyLogger() override;
 
     juce::File getTempDir() const { return sessionTempDir; }
 
-    // Logs via OmnifyLogger directly
+    // Logs via OmnifyLogger directly. Any thread but the audio thread: copies the message and wakes the writer.
     void log(const juce::String& message);
 
-    // Also sets itself as juce::Logger::currentLogger, so Logger::writeToLog() works too
+    // Audio thread: never formats, allocates or locks, and doesn't wake the writer, which picks the record up within
+    // WRITE_INTERVAL_MS. format must be a string literal; the writer replaces each {} in it with the next argument.
+    template <typename... Args>
+    void logRT(const char* format, Args... args) {
+        static_assert(sizeof...(Args) <= MAX_RT_ARGS, "logRT takes at most MAX_RT_ARGS arguments");
+        static_assert((std::is_arithmetic_v<Args> && ...), "logRT only takes numbers");
+
+        Record record;
+        record.timeMs = juce::Time::currentTimeMillis();
+        record.format = format;
+        record.numArgs = static_cast<uint8_t>(sizeof...(Args));
+        size_t i = 0;
+        ((record.args[i++] = toArg(args)), ...);
+        enqueue(record);
+    }
+
+    // Records dropped because the queue was full
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
 
    private:
+    struct Arg {
+        bool isInteger = true;
+        int64_t integer = 0;
+        double real = 0.0;
+    };
+
+    struct Record {
+        int64_t timeMs = 0;
+        const char* format = nullptr;  // logRT(): formatted by the writer. Otherwise text holds the message.
+        std::array<Arg, MAX_RT_ARGS> args{};
+        uint8_t numArgs = 0;
+        uint16_t textLength = 0;
+        std::array<char, MAX_MESSAGE_BYTES> text;
+    };
+
+    template <typename T>
+    static Arg toArg(T value) {
+        if constexpr (std::is_integral_v<T>) {
+            return {true, static_cast<int64_t>(value), 0.0};
+        } else {
+            return {false, 0, static_cast<double>(value)};
+        }
+    }
+
+    // juce::Logger
+    void logMessage(const juce::String& message) override { log(message); }
+
+    void run() override;
+    void enqueue(const Record& record);
+
+    // Writer thread (or the destructor, once it has stopped): formats and writes everything queued
+    void writePending();
+    static juce::String format(const Record& record);
+
     juce::File sessionTempDir;
-    std::unique_ptr<juce::FileLogger> logger;
+    std::unique_ptr<juce::FileOutputStream> logStream;
+
+    MpscQueue<Record> queue{QUEUE_CAPACITY};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0;  // writer thread
 
     static juce::String getSystemTempDir();
 };
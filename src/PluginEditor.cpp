@@ -29,6 +29,9 @@ OmnifyAudioProcessorEditor::OmnifyAudioProcessorEditor(OmnifyAudioProcessor& p)
             s.output = useDaw ? DawOrDevice{Daw{}} : DawOrDevice{Device{portName.toStdString()}};
         });
     };
+    midiIOPanel.onDirectModeChanged = [this](bool direct) {
+        omnifyProcessor.modifySettings([direct](OmnifySettings& s) { s.directMode = direct; });
+    };
     addAndMakeVisible(midiIOPanel);
 
     // Panels
@@ -41,6 +44,11 @@ OmnifyAudioProcessorEditor::OmnifyAudioProcessorEditor(OmnifyAudioProcessor& p)
     chordQualityDisplay.setColour(juce::Label::textColourId, LcarsColors::africanViolet);
     addAndMakeVisible(chordQualityDisplay);
 
+    // Bottom row - engine stats, hidden until toggled
+    statsDisplay.setJustificationType(juce::Justification::centredLeft);
+    statsDisplay.setColour(juce::Label::textColourId, LcarsColors::africanViolet);
+    addChildComponent(statsDisplay);
+
     // Bottom row - keyboard display
     keyboardDisplay.setWhiteKeyColour(LcarsColors::africanViolet);
     keyboardDisplay.setBlackKeyColour(juce::Colours::black);
@@ -64,12 +72,36 @@ bool OmnifyAudioProcessorEditor::keyPressed(const juce::KeyPress& key) {
         omnifyProcessor.setChordQuality(ALL_CHORD_QUALITIES[static_cast<size_t>(index)]);
         return true;
     }
+    // S toggles the engine stats
+    if (juce::CharacterFunctions::toUpperCase(key.getTextCharacter()) == 'S') {
+        bool showStats = !statsDisplay.isVisible();
+        statsDisplay.setVisible(showStats);
+        chordQualityDisplay.setVisible(!showStats);
+        statsRefreshCountdown = 0;
+        return true;
+    }
+    // T dumps the engine trace to the session temp dir
+    if (juce::CharacterFunctions::toUpperCase(key.getTextCharacter()) == 'T') {
+        omnifyProcessor.dumpTrace();
+        return true;
+    }
     return false;
 }
 
 void OmnifyAudioProcessorEditor::timerCallback() { updateDisplayState(); }
 
 void OmnifyAudioProcessorEditor::updateDisplayState() {
+    if (statsDisplay.isVisible()) {
+        updateStatsDisplay();
+    }
+
+    // Nothing to do unless the chord state has moved on since the last update
+    auto version = omnifyProcessor.getDisplayVersion();
+    if (version == shownDisplayVersion) {
+        return;
+    }
+    shownDisplayVersion = version;
+
     // Update chord quality display
     auto quality = omnifyProcessor.getDisplayChordQuality();
     const auto& qualityData = getChordQualityData(quality);
@@ -92,6 +124,27 @@ void OmnifyAudioProcessorEditor::updateDisplayState() {
     keyboardDisplay.setActiveNotes(activeNotes);
 }
 
+void OmnifyAudioProcessorEditor::updateStatsDisplay() {
+    // Twice a second is plenty, and gives the rates something to average over
+    if (statsRefreshCountdown-- > 0) {
+        return;
+    }
+    statsRefreshCountdown = 15;
+
+    auto stats = omnifyProcessor.getStats();
+    auto micros = [](int64_t ns) { return juce::String(static_cast<double>(ns) / 1000.0, 1); };
+    juce::String text;
+    text << "block us p50 " << micros(stats.blockTimePercentileNs(0.5)) << "  p99 " << micros(stats.blockTimePercentileNs(0.99))
+         << "  max " << micros(stats.maxBlockNs) << "\n";
+    text << "events/s in " << juce::String(stats.eventsInPerSecond(lastStats), 0) << "  out "
+         << juce::String(stats.eventsOutPerSecond(lastStats), 0) << "  overruns " << juce::String(stats.overruns) << "\n";
+    text << "strums cut cooldown " << juce::String(stats.strumsSuppressedByCooldown) << "  dead zone "
+         << juce::String(stats.strumsSuppressedByDeadZone) << "  queue " << juce::String(stats.schedulerDepth) << "/"
+         << juce::String(stats.maxSchedulerDepth);
+    statsDisplay.setText(text, juce::dontSendNotification);
+    lastStats = stats;
+}
+
 void OmnifyAudioProcessorEditor::refreshFromSettings() {
     auto settings = omnifyProcessor.getSettings();
 
@@ -106,6 +159,7 @@ void OmnifyAudioProcessorEditor::refreshFromSettings() {
     } else {
         midiIOPanel.setOutputPortName("Omnify");
     }
+    midiIOPanel.setDirectMode(settings->directMode);
 
     // Panels
     chordSettings.refreshFromSettings();
@@ -130,6 +184,7 @@ void OmnifyAudioProcessorEditor::resized() {
     if (auto* laf = dynamic_cast<LcarsLookAndFeel*>(&getLookAndFeel())) {
         titleLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeTitle));
         chordQualityDisplay.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeTitle));
+        statsDisplay.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeTiny));
     }
 
     auto topArea = bounds.removeFromTop(70);
@@ -148,6 +203,7 @@ void OmnifyAudioProcessorEditor::resized() {
     bottomRow.items.add(juce::FlexItem(chordQualityDisplay).withFlex(1.0F).withMargin(3));
     bottomRow.items.add(juce::FlexItem(keyboardDisplay).withFlex(2.0F).withMargin(3));
     bottomRow.performLayout(bottomArea);
+    statsDisplay.setBounds(chordQualityDisplay.getBounds());
 
     bounds.removeFromBottom(6);
 
@@ -3,6 +3,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 
+#include <optional>
+
 #include "PluginProcessor.h"
 #include "ui/components/MidiIOPanel.h"
 #include "ui/components/PianoKeyboardDisplay.h"
@@ -23,8 +25,10 @@ class OmnifyAudioProcessorEditor : public juce::AudioProcessorEditor, private ju
    private:
     void timerCallback() override;
     void updateDisplayState();
+    void updateStatsDisplay();
 
     OmnifyAudioProcessor& omnifyProcessor;
+    std::optional<uint64_t> shownDisplayVersion;  // what the bottom row currently shows
 
     // Top-level components
     juce::Label titleLabel;
@@ -37,5 +41,10 @@ class OmnifyAudioProcessorEditor : public juce::AudioProcessorEditor, private ju
     juce::Label chordQualityDisplay;
     PianoKeyboardDisplay keyboardDisplay;
 
+    // Engine stats, toggled with the S key in place of the chord quality display
+    juce::Label statsDisplay;
+    EngineStats::Snapshot lastStats;
+    int statsRefreshCountdown = 0;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OmnifyAudioProcessorEditor)
 };
@@ -38,16 +38,21 @@ OmnifyAudioProcessor::OmnifyAudioProcessor()
     omnifySettings = std::make_shared<OmnifySettings>();
 
     omnify = std::make_unique<Omnify>(*midiScheduler, omnifySettings, realtimeParams);
+    directProcessor = std::make_unique<DirectMidiProcessor>(*omnify, *midiScheduler, engineLock, midiOutputThread);
+    midiOutputThread.setTrace(&omnify->getTrace());
+    deviceWatcher->addChangeListener(this);
 }
 
 OmnifyAudioProcessor::~OmnifyAudioProcessor() {
     juce::LookAndFeel::setDefaultLookAndFeel(nullptr);
     cancelPendingUpdate();
+    deviceWatcher->removeChangeListener(this);
     if (midiInput) {
         midiInput->stop();
         midiInput.reset();
     }
-    std::atomic_store(&midiOutput, std::shared_ptr<juce::MidiOutput>{nullptr});
+    directProcessor->stop();
+    midiOutputThread.setOutput(nullptr);
 
     parameters.removeParameterListener("strum_gate_time_ms", this);
     parameters.removeParameterListener("strum_cooldown_ms", this);
@@ -55,61 +60,103 @@ OmnifyAudioProcessor::~OmnifyAudioProcessor() {
 
 void OmnifyAudioProcessor::prepareToPlay(double sr, int samplesPerBlock) {
     juce::ignoreUnused(samplesPerBlock);
-    sampleRate = sr;
-    currentSamplePosition = 0;
-    midiScheduler->setSampleRate(sr);
-    omnify->setSampleRate(sr);
-    inputCollector.reset(sr);
+    // Direct mode may still be running on the timer and input threads: stop its timer, and hold engineLock so the
+    // input thread waits until everything is re-prepared
+    directProcessor->stop();
+    {
+        const juce::ScopedLock lock(engineLock);
+        sampleRate = sr;
+        currentSamplePosition = 0;
+        // Size the scheduler for the longest gate the parameter allows
+        midiScheduler->prepare(sr, static_cast<double>(strumGateTimeParam->range.end));
+        omnify->setSampleRate(sr);
+        inputFifo.reset(sr);
+        inputBuffer.ensureSize(MIDI_BUFFER_BYTES);
+        outputBuffer.ensureSize(MIDI_BUFFER_BYTES);
+        carriedInput.ensureSize(MIDI_BUFFER_BYTES);
+        publishedSamplePosition.store(0);
+        omnify->getStats().reset();
+    }
+    if (directMode.load()) {
+        directProcessor->start(sr, 0);
+    }
 }
 
-void OmnifyAudioProcessor::releaseResources() {}
+void OmnifyAudioProcessor::releaseResources() { logger->log("Engine stats:\n" + omnify->getStats().snapshot().toString()); }
 
 void OmnifyAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    rtcheck::ScopedRealtimeSection realtimeSection;
     buffer.clear();
+    double blockStartMs = juce::Time::getMillisecondCounterHiRes();
+    auto blockStartTicks = juce::Time::getHighResolutionTicks();
+
+    if (directMode.load()) {
+        // Omnify is running on the midi input thread, so the block clock just follows the direct clock. Input and
+        // output are devices, so the host's midi passes through untouched.
+        currentSamplePosition = directProcessor->nowSample();
+        publishedSamplePosition.store(currentSamplePosition, std::memory_order_relaxed);
+        return;
+    }
 
-    auto settings = std::atomic_load(&omnifySettings);
+    auto& trace = omnify->getTrace();
+    trace.record(TraceRing::Kind::BLOCK_BEGIN, TraceRing::Track::AUDIO, 0, buffer.getNumSamples());
+
+    auto settings = omnify->readSettings();
     bool inputFromDevice = isDevice(settings->input);
     bool outputToDevice = isDevice(settings->output);
 
-    juce::MidiBuffer inputBuffer;
+    inputBuffer.clear();
+    outputBuffer.clear();
 
     if (inputFromDevice) {
-        inputCollector.removeNextBlockOfMessages(inputBuffer, buffer.getNumSamples());
+        inputFifo.removeNextBlockOfMessages(inputBuffer, buffer.getNumSamples());
     } else {
         inputBuffer.swapWith(midiMessages);
     }
 
-    juce::MidiBuffer outputBuffer;
-
-    for (const auto metadata : inputBuffer) {
-        auto msg = metadata.getMessage();
-        int64_t msgSample = currentSamplePosition + metadata.samplePosition;
-
-        MidiLearnComponent::broadcastMidi(msg);
-
-        try {
-            auto outputMessages = omnify->handle(msg, msgSample);
-            for (const auto& outMsg : outputMessages) {
-                outputBuffer.addEvent(outMsg, metadata.samplePosition);
-            }
-        } catch (const std::exception& e) {
-            DBG("processBlock: exception in handle(): " << e.what());
+    if (MidiLearnComponent::isAnyoneLearning()) {
+        for (const auto metadata : inputBuffer) {
+            MidiLearnComponent::broadcastMidi(metadata.getMessage());
         }
     }
 
+    // The lock is only contended while direct mode is switching on or off. The block's input is then held back until
+    // the engine is free again rather than waited on, or dropped: a lost note-off would leave a chord stuck.
+    const juce::ScopedTryLock engineTryLock(engineLock);
+    bool rewritten = true;
+    if (engineTryLock.isLocked()) {
+        if (!carriedInput.isEmpty()) {
+            // Held back events go first, at the start of this block
+            carriedInput.addEvents(inputBuffer, 0, -1, 0);
+            inputBuffer.clear();
+            inputBuffer.addEvents(carriedInput, 0, -1, 0);
+            carriedInput.clear();
+        }
+        // When nothing was consumed or scheduled the input is passed through as is
+        rewritten = omnify->processMidiBlock(inputBuffer, currentSamplePosition, buffer.getNumSamples(), outputBuffer);
+    } else {
+        for (const auto metadata : inputBuffer) {
+            carriedInput.addEvent(metadata.data, metadata.numBytes, 0);
+        }
+        logger->logRT("processBlock: engine busy switching modes, held back {} input events", inputBuffer.getNumEvents());
+    }
+    auto& blockOutput = rewritten ? outputBuffer : inputBuffer;
     int64_t blockEndSample = currentSamplePosition + buffer.getNumSamples();
-    midiScheduler->collectOverdueMessages(currentSamplePosition, blockEndSample, outputBuffer);
+
+    trace.record(TraceRing::Kind::BLOCK_END, TraceRing::Track::AUDIO, 0, blockOutput.getNumEvents());
 
     if (outputToDevice) {
-        auto output = std::atomic_load(&midiOutput);
-        if (output) {
-            output->sendBlockOfMessagesNow(outputBuffer);
-        }
+        midiOutputThread.enqueue(blockOutput, blockStartMs, sampleRate);
     } else {
-        midiMessages.swapWith(outputBuffer);
+        midiMessages.swapWith(blockOutput);
     }
 
     currentSamplePosition = blockEndSample;
+    publishedSamplePosition.store(currentSamplePosition, std::memory_order_relaxed);
+
+    auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks);
+    omnify->getStats().recordBlock(static_cast<int64_t>(elapsedSeconds * 1.0e9),
+                                   static_cast<int64_t>(buffer.getNumSamples() * 1.0e9 / sampleRate));
 }
 
 juce::AudioProcessorEditor* OmnifyAudioProcessor::createEditor() { return new OmnifyAudioProcessorEditor(*this); }
@@ -153,6 +200,16 @@ void OmnifyAudioProcessor::setStateInformation(const void* data, int sizeInBytes
     }
 }
 
+juce::File OmnifyAudioProcessor::dumpTrace() {
+    auto file = logger->getTempDir().getChildFile("trace-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+    if (!omnify->getTrace().writeChromeTrace(file)) {
+        logger->log("Failed to write trace to " + file.getFullPathName());
+        return {};
+    }
+    logger->log("Wrote trace to " + file.getFullPathName());
+    return file;
+}
+
 void OmnifyAudioProcessor::modifySettings(std::function<void(OmnifySettings&)> mutator) {
     auto newSettings = std::make_shared<OmnifySettings>(*omnifySettings);
     mutator(*newSettings);
@@ -170,28 +227,42 @@ void OmnifyAudioProcessor::parameterChanged(const juce::String& parameterID, flo
     }
 }
 
-void OmnifyAudioProcessor::handleAsyncUpdate() { reconcileDevices(); }
+void OmnifyAudioProcessor::handleAsyncUpdate() {
+    omnify->reclaimSettings();
+    reconcileDevices();
+}
+
+void OmnifyAudioProcessor::changeListenerCallback(juce::ChangeBroadcaster*) { reconcileDevices(); }
 
 void OmnifyAudioProcessor::reconcileDevices() {
     auto settings = std::atomic_load(&omnifySettings);
 
-    // Reconcile input device
+    // Direct mode starts before the input is handed to it, and stops after the input is taken back
+    bool wantDirect = settings->directMode && isDevice(settings->input) && isDevice(settings->output);
+    if (wantDirect && !directMode.load()) {
+        directProcessor->start(sampleRate, publishedSamplePosition.load());
+        directMode.store(true);
+    }
+    juce::MidiInputCallback* desiredCallback = wantDirect ? static_cast<juce::MidiInputCallback*>(directProcessor.get()) : &inputFifo;
+
+    // Reconcile input device. Runs again whenever the device watcher sees the device list change, so an input that
+    // was unplugged is closed, and reopened when it comes back.
     if (isDevice(settings->input)) {
-        juce::String desiredName = juce::String(getDeviceName(settings->input));
-        juce::String currentName = midiInput ? midiInput->getName() : juce::String();
+        auto desired = deviceWatcher->findInput(juce::String(getDeviceName(settings->input)));
 
-        if (desiredName != currentName) {
+        if (!desired || desired->identifier != midiInputIdentifier || desiredCallback != midiInputCallback) {
             if (midiInput) {
                 midiInput->stop();
                 midiInput.reset();
+                midiInputCallback = nullptr;
+                midiInputIdentifier = {};
             }
-            for (const auto& device : juce::MidiInput::getAvailableDevices()) {
-                if (device.name == desiredName) {
-                    midiInput = juce::MidiInput::openDevice(device.identifier, &inputCollector);
-                    if (midiInput) {
-                        midiInput->start();
-                    }
-                    break;
+            if (desired) {
+                midiInput = juce::MidiInput::openDevice(desired->identifier, desiredCallback);
+                if (midiInput) {
+                    midiInputCallback = desiredCallback;
+                    midiInputIdentifier = desired->identifier;
+                    midiInput->start();
                 }
             }
         }
@@ -199,21 +270,35 @@ void OmnifyAudioProcessor::reconcileDevices() {
         if (midiInput) {
             midiInput->stop();
             midiInput.reset();
+            midiInputCallback = nullptr;
+            midiInputIdentifier = {};
         }
     }
 
-    // Reconcile output device
+    // Reconcile output device. Omnify's own ports are created, and recreated if creating one failed. Any other name is
+    // an existing device, which like the input is closed when it's unplugged and reopened when it comes back.
     if (isDevice(settings->output)) {
         juce::String desiredName = juce::String(getDeviceName(settings->output));
-        auto currentOutput = std::atomic_load(&midiOutput);
-        juce::String currentName = currentOutput ? currentOutput->getName() : juce::String();
-
-        if (desiredName != currentName) {
-            auto newOutput = juce::MidiOutput::createNewDevice(desiredName);
-            std::atomic_store(&midiOutput, std::shared_ptr<juce::MidiOutput>(std::move(newOutput)));
+        if (MidiDeviceWatcher::isOmnifyPort(desiredName)) {
+            if (desiredName != midiOutputThread.getOutputName() || midiOutputIdentifier.isNotEmpty()) {
+                midiOutputIdentifier = {};
+                midiOutputThread.setOutput(juce::MidiOutput::createNewDevice(desiredName));
+            }
+        } else {
+            auto desired = deviceWatcher->findOutput(desiredName);
+            if (desired ? desired->identifier != midiOutputIdentifier : midiOutputThread.hasOutput()) {
+                midiOutputThread.setOutput(desired ? juce::MidiOutput::openDevice(desired->identifier) : nullptr);
+                midiOutputIdentifier = desired && midiOutputThread.hasOutput() ? desired->identifier : juce::String();
+            }
         }
-    } else {
-        std::atomic_store(&midiOutput, std::shared_ptr<juce::MidiOutput>{nullptr});
+    } else if (midiOutputThread.hasOutput()) {
+        midiOutputIdentifier = {};
+        midiOutputThread.setOutput(nullptr);
+    }
+
+    if (!wantDirect && directMode.load()) {
+        directMode.store(false);
+        directProcessor->stop();
     }
 }
 
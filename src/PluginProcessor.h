@@ -6,16 +6,22 @@
 #include <functional>
 #include <memory>
 
+#include "DirectMidiProcessor.h"
+#include "MidiDeviceWatcher.h"
+#include "MidiInputFifo.h"
 #include "MidiMessageScheduler.h"
+#include "MidiOutputThread.h"
 #include "Omnify.h"
 #include "OmnifyLogger.h"
+#include "RealtimeChecker.h"
 #include "ui/LcarsLookAndFeel.h"
 #include "ui/components/MidiLearnComponent.h"
 
 //==============================================================================
 class OmnifyAudioProcessor : public juce::AudioProcessor,
                              private juce::AudioProcessorValueTreeState::Listener,
-                             private juce::AsyncUpdater {
+                             private juce::AsyncUpdater,
+                             private juce::ChangeListener {
    public:
     OmnifyAudioProcessor();
     ~OmnifyAudioProcessor() override;
@@ -57,6 +63,12 @@ class OmnifyAudioProcessor : public juce::AudioProcessor,
     ChordQuality getDisplayChordQuality() const { return omnify->getEnqueuedChordQuality(); }
     ChordNotes getDisplayChordNotes() const { return omnify->getChordNotes(); }
     int getDisplayCurrentRoot() const { return omnify->getCurrentRoot(); }  // -1 if no chord
+    uint64_t getDisplayVersion() const { return omnify->getDisplayVersion(); }
+    EngineStats::Snapshot getStats() const { return omnify->getStats().snapshot(); }
+
+    // Message thread: writes the engine's recent event timeline into the session temp dir as Chrome trace JSON
+    // (open it in ui.perfetto.dev). Returns the file, or an invalid one if it couldn't be written.
+    juce::File dumpTrace();
 
     // Thread-safe setter for UI input
     void setChordQuality(ChordQuality quality) { omnify->setEnqueuedChordQuality(quality); }
@@ -71,6 +83,7 @@ class OmnifyAudioProcessor : public juce::AudioProcessor,
 
     void parameterChanged(const juce::String& parameterID, float newValue) override;
     void handleAsyncUpdate() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     void applySettingsFromJson(const juce::String& jsonString);
     void loadSettingsFromValueTree();
     void saveSettingsToValueTree();
@@ -80,15 +93,45 @@ class OmnifyAudioProcessor : public juce::AudioProcessor,
     std::shared_ptr<OmnifySettings> omnifySettings;
     std::unique_ptr<Omnify> omnify;
 
+    juce::SharedResourcePointer<MidiDeviceWatcher> deviceWatcher;
     std::unique_ptr<juce::MidiInput> midiInput;
-    std::shared_ptr<juce::MidiOutput> midiOutput;
-    juce::MidiMessageCollector inputCollector;
+    juce::String midiInputIdentifier;
+    juce::MidiInputCallback* midiInputCallback = nullptr;
+    MidiOutputThread midiOutputThread;
+    juce::String midiOutputIdentifier;  // empty unless the output is a device Omnify opened, rather than its own port
+    MidiInputFifo inputFifo;
     double sampleRate = 44100.0;
     int64_t currentSamplePosition = 0;
     void reconcileDevices();
 
+    // Reused every block, so processBlock never allocates once these have grown to fit
+    static constexpr size_t MIDI_BUFFER_BYTES = 32 * 1024;
+    juce::MidiBuffer inputBuffer;
+    juce::MidiBuffer outputBuffer;
+    // Input from blocks that couldn't get engineLock, replayed at the start of the next block that does
+    juce::MidiBuffer carriedInput;
+
+    // Direct mode. Held by whichever thread is running omnify / the scheduler; processBlock only try-locks it.
+    juce::CriticalSection engineLock;
+    std::unique_ptr<DirectMidiProcessor> directProcessor;
+    std::atomic<bool> directMode{false};
+    std::atomic<int64_t> publishedSamplePosition{0};  // currentSamplePosition, for anchoring the direct clock
+
     juce::SharedResourcePointer<OmnifyLogger> logger;
 
+#if OMNIFY_RT_CHECK
+    // Logs whatever the real-time checker caught in processBlock
+    struct RealtimeViolationLogger : private juce::Timer {
+        explicit RealtimeViolationLogger(OmnifyLogger& logger) : logger(logger) { startTimer(1000); }
+        ~RealtimeViolationLogger() override { stopTimer(); }
+        void timerCallback() override {
+            rtcheck::reportViolations([this](const juce::String& report) { logger.log(report); });
+        }
+        OmnifyLogger& logger;
+    };
+    RealtimeViolationLogger realtimeViolationLogger{*logger};
+#endif
+
     LcarsLookAndFeel lcarsLookAndFeel;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OmnifyAudioProcessor)
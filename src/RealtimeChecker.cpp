@@ -0,0 +1,296 @@
+#include "RealtimeChecker.h"
+
+#if !OMNIFY_RT_CHECK
+
+size_t rtcheck::reportViolations(const std::function<void(const juce::String&)>&) { return 0; }
+
+#else
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+#include <semaphore.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+enum class ViolationKind { Allocation, Deallocation, MutexLock, RwLock, SemaphoreWait };
+
+constexpr size_t MAX_FRAMES = 32;
+constexpr size_t MAX_VIOLATIONS = 64;
+
+enum RecordState : int { EMPTY, WRITING, READY };
+
+struct Violation {
+    std::atomic<int> state{EMPTY};
+    ViolationKind kind = ViolationKind::Allocation;
+    int numFrames = 0;
+    std::array<void*, MAX_FRAMES> frames{};
+};
+
+std::array<Violation, MAX_VIOLATIONS> violations;
+std::atomic<size_t> numDropped{0};
+
+struct ThreadState {
+    int realtimeDepth = 0;
+    bool recording = false;  // backtrace() mustn't be reported as a violation of its own
+};
+
+// initial-exec, so touching it from inside malloc can't itself allocate TLS
+#if defined(__linux__)
+__attribute__((tls_model("initial-exec")))
+#endif
+thread_local ThreadState threadState;
+
+void recordViolation(ViolationKind kind) {
+    auto& state = threadState;
+    if (state.realtimeDepth == 0 || state.recording) {
+        return;
+    }
+    state.recording = true;
+
+    bool recorded = false;
+    for (auto& v : violations) {
+        int expected = EMPTY;
+        if (v.state.compare_exchange_strong(expected, WRITING)) {
+            v.kind = kind;
+            v.numFrames = backtrace(v.frames.data(), static_cast<int>(MAX_FRAMES));
+            v.state.store(READY);
+            recorded = true;
+            break;
+        }
+    }
+    if (!recorded) {
+        numDropped.fetch_add(1);
+    }
+
+    state.recording = false;
+}
+
+// The first backtrace() call loads the unwinder, which allocates, so do it before anything is being checked
+const bool backtracePrimed = [] {
+    std::array<void*, 1> frame{};
+    return backtrace(frame.data(), 1) >= 0;
+}();
+
+juce::String describe(ViolationKind kind) {
+    switch (kind) {
+        case ViolationKind::Allocation:
+            return "allocation";
+        case ViolationKind::Deallocation:
+            return "deallocation";
+        case ViolationKind::MutexLock:
+            return "mutex lock";
+        case ViolationKind::RwLock:
+            return "read-write lock";
+        case ViolationKind::SemaphoreWait:
+            return "semaphore wait";
+    }
+    return "unknown";
+}
+
+//==============================================================================
+// The allocator underneath the interceptors
+
+#if defined(__linux__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+}
+
+void* rawMalloc(size_t size) { return __libc_malloc(size); }
+void rawFree(void* ptr) { __libc_free(ptr); }
+#else
+void* rawMalloc(size_t size) { return std::malloc(size); }
+void rawFree(void* ptr) { std::free(ptr); }
+#endif
+
+// The functions the lock interceptors stand in for. Not function-local statics: their guards could end up in
+// pthread_mutex_lock.
+std::atomic<void*> cachedMutexLock{nullptr};
+std::atomic<void*> cachedRwlockRdlock{nullptr};
+std::atomic<void*> cachedRwlockWrlock{nullptr};
+std::atomic<void*> cachedSemWait{nullptr};
+
+template <typename Fn>
+Fn realFunction(std::atomic<void*>& cached, const char* name) {
+    void* fn = cached.load(std::memory_order_relaxed);
+    if (fn == nullptr) {
+        fn = dlsym(RTLD_NEXT, name);
+        cached.store(fn, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Fn>(fn);
+}
+
+}  // namespace
+
+//==============================================================================
+
+rtcheck::ScopedRealtimeSection::ScopedRealtimeSection() { threadState.realtimeDepth++; }
+rtcheck::ScopedRealtimeSection::~ScopedRealtimeSection() { threadState.realtimeDepth--; }
+
+size_t rtcheck::reportViolations(const std::function<void(const juce::String&)>& log) {
+    size_t count = numDropped.exchange(0);
+    if (count > 0) {
+        log(juce::String(static_cast<int>(count)) + " real-time violations were not recorded, the buffer was full");
+    }
+
+    for (auto& v : violations) {
+        if (v.state.load() != READY) {
+            continue;
+        }
+        count++;
+
+        juce::String report = "Real-time violation: " + describe(v.kind) + " on a real-time thread\n";
+        if (char** symbols = backtrace_symbols(v.frames.data(), v.numFrames)) {
+            for (int i = 0; i < v.numFrames; i++) {
+                report << "    " << symbols[i] << "\n";
+            }
+            std::free(symbols);
+        }
+        v.state.store(EMPTY);
+
+        log(report);
+    }
+    return count;
+}
+
+//==============================================================================
+// Interceptors. In the plugin (hidden visibility) they replace the plugin's own calls; in an executable they
+// replace everyone's.
+
+void* operator new(size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    if (void* p = rawMalloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    recordViolation(ViolationKind::Allocation);
+    return rawMalloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+
+void operator delete(void* ptr) noexcept {
+    if (ptr != nullptr) {
+        recordViolation(ViolationKind::Deallocation);
+    }
+    rawFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete(ptr); }
+
+#if defined(__linux__)
+
+extern "C" {
+void* malloc(size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (ptr != nullptr) {
+        recordViolation(ViolationKind::Deallocation);
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    recordViolation(ViolationKind::MutexLock);
+    return realFunction<int (*)(pthread_mutex_t*)>(cachedMutexLock, "pthread_mutex_lock")(mutex);
+}
+
+int pthread_rwlock_rdlock(pthread_rwlock_t* lock) {
+    recordViolation(ViolationKind::RwLock);
+    return realFunction<int (*)(pthread_rwlock_t*)>(cachedRwlockRdlock, "pthread_rwlock_rdlock")(lock);
+}
+
+int pthread_rwlock_wrlock(pthread_rwlock_t* lock) {
+    recordViolation(ViolationKind::RwLock);
+    return realFunction<int (*)(pthread_rwlock_t*)>(cachedRwlockWrlock, "pthread_rwlock_wrlock")(lock);
+}
+
+int sem_wait(sem_t* semaphore) {
+    recordViolation(ViolationKind::SemaphoreWait);
+    return realFunction<int (*)(sem_t*)>(cachedSemWait, "sem_wait")(semaphore);
+}
+}
+
+#elif defined(__APPLE__)
+
+// dyld only applies interposing from images loaded at launch, e.g. the harness, or the plugin via
+// DYLD_INSERT_LIBRARIES. operator new / delete above are caught either way.
+#define OMNIFY_DYLD_INTERPOSE(replacement, replacee)                                                 \
+    __attribute__((used)) static struct {                                                            \
+        const void* replacementFn;                                                                   \
+        const void* replaceeFn;                                                                      \
+    } interpose_##replacee __attribute__((section("__DATA,__interpose"))) = {                        \
+        reinterpret_cast<const void*>(&replacement), reinterpret_cast<const void*>(&replacee)}
+
+namespace {
+void* checkedMalloc(size_t size) {
+    recordViolation(ViolationKind::Allocation);
+    return malloc(size);
+}
+
+void checkedFree(void* ptr) {
+    if (ptr != nullptr) {
+        recordViolation(ViolationKind::Deallocation);
+    }
+    free(ptr);
+}
+
+int checkedMutexLock(pthread_mutex_t* mutex) {
+    recordViolation(ViolationKind::MutexLock);
+    return pthread_mutex_lock(mutex);
+}
+
+int checkedRwlockRdlock(pthread_rwlock_t* lock) {
+    recordViolation(ViolationKind::RwLock);
+    return pthread_rwlock_rdlock(lock);
+}
+
+int checkedRwlockWrlock(pthread_rwlock_t* lock) {
+    recordViolation(ViolationKind::RwLock);
+    return pthread_rwlock_wrlock(lock);
+}
+
+int checkedSemWait(sem_t* semaphore) {
+    recordViolation(ViolationKind::SemaphoreWait);
+    return sem_wait(semaphore);
+}
+}  // namespace
+
+OMNIFY_DYLD_INTERPOSE(checkedMalloc, malloc);
+OMNIFY_DYLD_INTERPOSE(checkedFree, free);
+OMNIFY_DYLD_INTERPOSE(checkedMutexLock, pthread_mutex_lock);
+OMNIFY_DYLD_INTERPOSE(checkedRwlockRdlock, pthread_rwlock_rdlock);
+OMNIFY_DYLD_INTERPOSE(checkedRwlockWrlock, pthread_rwlock_wrlock);
+OMNIFY_DYLD_INTERPOSE(checkedSemWait, sem_wait);
+
+#endif
+
+#endif  // OMNIFY_RT_CHECK
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <cstddef>
+#include <functional>
+
+#ifndef OMNIFY_RT_CHECK
+#define OMNIFY_RT_CHECK 0
+#endif
+
+/**
+ * Real-time safety checking, for debugging builds configured with -DOMNIFY_RT_CHECK=ON.
+ *
+ * In that mode malloc / free, operator new / delete and the blocking lock calls (pthread_mutex_lock,
+ * pthread_rwlock_rdlock / wrlock and sem_wait) are intercepted, and any call made on a thread inside a
+ * ScopedRealtimeSection is recorded with a stack trace. Recording never allocates or locks, and reportViolations()
+ * symbolizes and hands them out later from a normal thread.
+ *
+ * Try-locks (pthread_mutex_trylock and friends) are deliberately allowed: they never wait, and processBlock relies on
+ * one to share the engine with direct mode.
+ *
+ * In normal builds ScopedRealtimeSection does nothing and nothing is intercepted.
+ */
+namespace rtcheck {
+
+class ScopedRealtimeSection {
+   public:
+#if OMNIFY_RT_CHECK
+    ScopedRealtimeSection();
+    ~ScopedRealtimeSection();
+#else
+    ScopedRealtimeSection() {}
+    ~ScopedRealtimeSection() {}
+#endif
+
+    JUCE_DECLARE_NON_COPYABLE(ScopedRealtimeSection)
+};
+
+// Calls log once per violation recorded since the last call, with a description and stack trace. Allocates, so never
+// call it from a real-time thread. Returns the number of violations, including any that didn't fit the record buffer.
+size_t reportViolations(const std::function<void(const juce::String&)>& log);
+
+}  // namespace rtcheck
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * A single writer, many reader sequence lock for small trivially copyable values, such as state the audio thread
+ * publishes for the editor.
+ *
+ * store() never waits: it bumps the sequence number to odd, writes, and bumps it back to even. load() copies the value
+ * and retries if a store overlapped it, so only readers can ever spin. The value is kept in atomic words, so a torn
+ * read is detected and discarded rather than being a data race.
+ *
+ * Stores from more than one thread must be serialized by the caller.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static_assert(std::is_default_constructible_v<T>);
+
+   public:
+    SeqLock() { store(T{}); }
+    explicit SeqLock(const T& initial) { store(initial); }
+
+    // Writer side, wait-free
+    void store(const T& value) {
+        std::array<uint64_t, NUM_WORDS> staged{};
+        std::memcpy(staged.data(), &value, sizeof(T));
+
+        auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < NUM_WORDS; i++) {
+            words[i].store(staged[i], std::memory_order_relaxed);
+        }
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side: retries while a store is in progress
+    T load() const {
+        std::array<uint64_t, NUM_WORDS> copied{};
+        while (true) {
+            auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                for (size_t i = 0; i < NUM_WORDS; i++) {
+                    copied[i] = words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before) {
+                    break;
+                }
+            }
+        }
+
+        T value;
+        std::memcpy(static_cast<void*>(&value), copied.data(), sizeof(T));
+        return value;
+    }
+
+   private:
+    static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint64_t> sequence{0};
+    std::array<std::atomic<uint64_t>, NUM_WORDS> words{};
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+/**
+ * Publishes immutable snapshots from one writer thread (the message thread) to a fixed set of real-time readers.
+ *
+ * Readers are wait-free: entering a ReadScope is an epoch load, an epoch store and a pointer load, with no locks,
+ * allocation or reference counting. The writer keeps ownership of every snapshot; replaced ones are retired and
+ * freed on the writer's thread by reclaim() once no reader can still be looking at them.
+ *
+ * Each reader thread uses its own reader index. ReadScopes nest on the same index, and the inner scope sees the
+ * snapshot pinned by the outermost one.
+ */
+template <typename T, size_t NumReaders = 1>
+class SnapshotPublisher {
+   private:
+    static constexpr uint64_t IDLE = std::numeric_limits<uint64_t>::max();
+
+    // Written only by its reader, except that the writer reads epoch
+    struct ReaderSlot {
+        std::atomic<uint64_t> epoch{IDLE};
+        const T* pinned = nullptr;
+        int depth = 0;
+    };
+
+   public:
+    explicit SnapshotPublisher(std::shared_ptr<const T> initial) : owned(std::move(initial)) { current.store(owned.get()); }
+
+    class ReadScope {
+       public:
+        ReadScope(SnapshotPublisher& publisher, size_t reader) : slot(publisher.readers[reader]) {
+            if (slot.depth++ == 0) {
+                slot.epoch.store(publisher.epoch.load());
+                slot.pinned = publisher.current.load();
+            }
+        }
+
+        ~ReadScope() {
+            if (--slot.depth == 0) {
+                slot.epoch.store(IDLE, std::memory_order_release);
+            }
+        }
+
+        const T& operator*() const { return *slot.pinned; }
+        const T* operator->() const { return slot.pinned; }
+
+       private:
+        ReaderSlot& slot;
+
+        JUCE_DECLARE_NON_COPYABLE(ReadScope)
+    };
+
+    // Reader side, wait-free. reader must be < NumReaders and only ever used from one thread at a time.
+    ReadScope read(size_t reader = 0) { return ReadScope(*this, reader); }
+
+    // Writer side. Also frees whatever earlier snapshots are no longer in use.
+    void publish(std::shared_ptr<const T> next) {
+        retired.push_back({std::move(owned), 0});
+        owned = std::move(next);
+        current.store(owned.get());
+        retired.back().epoch = epoch.fetch_add(1) + 1;
+        reclaim();
+    }
+
+    // Writer side: the latest published snapshot
+    const std::shared_ptr<const T>& latest() const { return owned; }
+
+    // Writer side: frees retired snapshots that every reader has moved past
+    void reclaim() {
+        std::erase_if(retired, [this](const Retired& r) {
+            for (const auto& reader : readers) {
+                if (reader.epoch.load() < r.epoch) {
+                    return false;
+                }
+            }
+            return true;
+        });
+    }
+
+    size_t getNumRetired() const { return retired.size(); }
+
+   private:
+    struct Retired {
+        std::shared_ptr<const T> snapshot;
+        uint64_t epoch;
+    };
+
+    // A reader that announced epoch e loaded `current` after the writer published every snapshot retired at <= e,
+    // so those can't be pinned by it. All accesses to these are seq_cst for that ordering argument to hold.
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<const T*> current{nullptr};
+    std::array<ReaderSlot, NumReaders> readers;
+
+    // Writer-thread only
+    std::shared_ptr<const T> owned;
+    std::vector<Retired> retired;
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<const T*>::is_always_lock_free);
+
+    JUCE_DECLARE_NON_COPYABLE(SnapshotPublisher)
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * A bounded, lock-free single producer / single consumer queue over juce::AbstractFifo.
+ *
+ * Storage is allocated in the constructor, so push() and pop() never allocate, lock or wait and are safe on the
+ * audio thread. Exactly one thread may push and exactly one (other) thread may pop.
+ */
+template <typename T>
+class SpscQueue {
+   public:
+    explicit SpscQueue(int capacity) : fifo(capacity), storage(static_cast<size_t>(capacity)) {}
+
+    // Producer side. Returns false when the queue is full.
+    bool push(const T& item) {
+        auto scope = fifo.write(1);
+        if (scope.blockSize1 > 0) {
+            storage[static_cast<size_t>(scope.startIndex1)] = item;
+            return true;
+        }
+        if (scope.blockSize2 > 0) {
+            storage[static_cast<size_t>(scope.startIndex2)] = item;
+            return true;
+        }
+        return false;
+    }
+
+    // Consumer side. Returns false when the queue is empty.
+    bool pop(T& item) {
+        auto scope = fifo.read(1);
+        if (scope.blockSize1 > 0) {
+            item = storage[static_cast<size_t>(scope.startIndex1)];
+            return true;
+        }
+        if (scope.blockSize2 > 0) {
+            item = storage[static_cast<size_t>(scope.startIndex2)];
+            return true;
+        }
+        return false;
+    }
+
+    int getNumReady() const { return fifo.getNumReady(); }
+    int getFreeSpace() const { return fifo.getFreeSpace(); }
+
+   private:
+    juce::AbstractFifo fifo;
+    std::vector<T> storage;
+
+    JUCE_DECLARE_NON_COPYABLE(SpscQueue)
+};
@@ -0,0 +1,132 @@
+#include "TraceRing.h"
+
+#include <algorithm>
+#include <json.hpp>
+
+namespace {
+const char* trackName(TraceRing::Track track) {
+    switch (track) {
+        case TraceRing::Track::AUDIO:
+            return "audio blocks";
+        case TraceRing::Track::MIDI_INPUT:
+            return "midi input";
+        case TraceRing::Track::NOTE_OFF_TIMER:
+            return "note-off timer";
+        case TraceRing::Track::DEVICE_OUTPUT:
+            return "device output";
+    }
+    return "unknown";
+}
+
+const char* outcomeName(TraceRing::Outcome outcome) {
+    switch (outcome) {
+        case TraceRing::Outcome::PASSTHROUGH:
+            return "passthrough";
+        case TraceRing::Outcome::CHORD_QUALITY:
+            return "chord quality";
+        case TraceRing::Outcome::STOP:
+            return "stop";
+        case TraceRing::Outcome::LATCH:
+            return "latch";
+        case TraceRing::Outcome::CHORD_ON:
+            return "chord on";
+        case TraceRing::Outcome::CHORD_OFF:
+            return "chord off";
+        case TraceRing::Outcome::STRUM:
+            return "strum";
+    }
+    return "unknown";
+}
+
+nlohmann::json midiArgs(uint16_t arg0) { return {{"status", arg0 >> 8}, {"data1", arg0 & 0xFF}}; }
+}  // namespace
+
+TraceRing::TraceRing() : slots(std::make_unique<Slot[]>(CAPACITY)) {}
+
+std::vector<TraceRing::Event> TraceRing::snapshot() const {
+    std::vector<Event> events;
+    events.reserve(CAPACITY);
+
+    for (size_t i = 0; i < CAPACITY; i++) {
+        const auto& slot = slots[i];
+        auto before = slot.stamp.load(std::memory_order_acquire);
+        if (before == 0 || (before & 1) != 0) {
+            continue;  // never written, or being written
+        }
+        auto ticks = slot.ticks.load(std::memory_order_relaxed);
+        auto payload = slot.payload.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.stamp.load(std::memory_order_relaxed) != before) {
+            continue;  // overwritten while we were reading it
+        }
+
+        Event e;
+        e.index = before / 2 - 1;
+        e.ticks = ticks;
+        e.kind = static_cast<Kind>(payload & 0xFF);
+        e.track = static_cast<Track>((payload >> 8) & 0xFF);
+        e.arg0 = static_cast<uint16_t>(payload >> 16);
+        e.arg1 = static_cast<int32_t>(static_cast<uint32_t>(payload >> 32));
+        events.push_back(e);
+    }
+
+    std::sort(events.begin(), events.end(), [](const Event& a, const Event& b) { return a.index < b.index; });
+    return events;
+}
+
+bool TraceRing::writeChromeTrace(const juce::File& file) const {
+    auto events = snapshot();
+    auto ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / 1.0e6;
+    auto origin = events.empty() ? 0 : events.front().ticks;
+
+    auto traceEvents = nlohmann::json::array();
+    for (auto track : {Track::AUDIO, Track::MIDI_INPUT, Track::NOTE_OFF_TIMER, Track::DEVICE_OUTPUT}) {
+        traceEvents.push_back(
+            {{"name", "thread_name"}, {"ph", "M"}, {"pid", 1}, {"tid", static_cast<int>(track)}, {"args", {{"name", trackName(track)}}}});
+    }
+
+    for (const auto& e : events) {
+        nlohmann::json j = {{"pid", 1}, {"tid", static_cast<int>(e.track)}, {"ts", static_cast<double>(e.ticks - origin) / ticksPerMicrosecond}};
+        switch (e.kind) {
+            case Kind::BLOCK_BEGIN:
+                j["name"] = "block";
+                j["ph"] = "B";
+                j["args"] = {{"samples", e.arg1}};
+                break;
+            case Kind::BLOCK_END:
+                j["ph"] = "E";
+                j["args"] = {{"events out", e.arg1}};
+                break;
+            case Kind::DISPATCH:
+                j["name"] = outcomeName(static_cast<Outcome>(e.arg1));
+                j["ph"] = "i";
+                j["s"] = "t";
+                j["args"] = midiArgs(e.arg0);
+                break;
+            case Kind::SCHEDULE:
+                j["name"] = e.arg1 < 0 ? "schedule rejected" : "schedule";
+                j["ph"] = "i";
+                j["s"] = "t";
+                j["args"] = midiArgs(e.arg0);
+                j["args"]["delay samples"] = e.arg1;
+                break;
+            case Kind::COLLECT:
+                j["name"] = "collect overdue";
+                j["ph"] = "i";
+                j["s"] = "t";
+                j["args"] = {{"messages", e.arg1}};
+                break;
+            case Kind::DEVICE_SEND:
+                j["name"] = "device send";
+                j["ph"] = "i";
+                j["s"] = "t";
+                j["args"] = midiArgs(e.arg0);
+                j["args"]["late us"] = e.arg1;
+                break;
+        }
+        traceEvents.push_back(std::move(j));
+    }
+
+    nlohmann::json trace = {{"traceEvents", std::move(traceEvents)}, {"displayTimeUnit", "ms"}};
+    return file.replaceWithText(juce::String(trace.dump()));
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * A fixed-size, lock-free ring of timestamped engine events, for looking at what happened around a glitch after the
+ * fact. Recording is a handful of relaxed atomic stores, so it stays on all the time; the oldest events are
+ * overwritten once the ring is full.
+ *
+ * Any thread may record. Each slot is its own little seqlock, so snapshot() can run on the message thread while
+ * events are still coming in, and just skips a slot that's being overwritten under it.
+ *
+ * writeChromeTrace() dumps the ring as Chrome trace JSON, which chrome://tracing and ui.perfetto.dev both open.
+ */
+class TraceRing {
+   public:
+    static constexpr size_t CAPACITY = 16384;  // a power of two
+
+    enum class Kind : uint8_t {
+        BLOCK_BEGIN,  // arg1: block size in samples
+        BLOCK_END,    // arg1: events out
+        DISPATCH,     // arg0: status and first data byte, arg1: Outcome
+        SCHEDULE,     // arg0: status and first data byte, arg1: delay in samples, or -1 if the scheduler was full
+        COLLECT,      // arg1: messages collected
+        DEVICE_SEND,  // arg0: status and first data byte, arg1: microseconds late
+    };
+
+    // Which handler consumed a message, for DISPATCH
+    enum class Outcome : int32_t { PASSTHROUGH, CHORD_QUALITY, STOP, LATCH, CHORD_ON, CHORD_OFF, STRUM };
+
+    // Timeline rows in the trace viewer
+    enum class Track : uint8_t { AUDIO, MIDI_INPUT, NOTE_OFF_TIMER, DEVICE_OUTPUT };
+
+    struct Event {
+        uint64_t index = 0;  // order of recording
+        int64_t ticks = 0;   // juce::Time::getHighResolutionTicks()
+        Kind kind = Kind::BLOCK_BEGIN;
+        Track track = Track::AUDIO;
+        uint16_t arg0 = 0;
+        int32_t arg1 = 0;
+    };
+
+    TraceRing();
+
+    // Any thread. Never blocks or allocates.
+    void record(Kind kind, Track track, uint16_t arg0 = 0, int32_t arg1 = 0) {
+        auto index = next.fetch_add(1, std::memory_order_relaxed);
+        auto& slot = slots[index & (CAPACITY - 1)];
+        slot.stamp.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.ticks.store(juce::Time::getHighResolutionTicks(), std::memory_order_relaxed);
+        slot.payload.store(pack(kind, track, arg0, arg1), std::memory_order_relaxed);
+        slot.stamp.store(index * 2 + 2, std::memory_order_release);
+    }
+
+    // Packs a short midi message's status and first data byte into arg0
+    static uint16_t midiArg(const uint8_t* data, int numBytes) {
+        return static_cast<uint16_t>((numBytes > 0 ? data[0] << 8 : 0) | (numBytes > 1 ? data[1] : 0));
+    }
+
+    // Any thread, allocates. Everything still in the ring, oldest first.
+    std::vector<Event> snapshot() const;
+
+    // Message thread: snapshot() as Chrome trace JSON. Returns false if the file couldn't be written.
+    bool writeChromeTrace(const juce::File& file) const;
+
+   private:
+    struct Slot {
+        std::atomic<uint64_t> stamp{0};  // odd while being written, otherwise 2 * (index + 1)
+        std::atomic<int64_t> ticks{0};
+        std::atomic<uint64_t> payload{0};
+    };
+
+    static uint64_t pack(Kind kind, Track track, uint16_t arg0, int32_t arg1) {
+        return static_cast<uint64_t>(kind) | (static_cast<uint64_t>(track) << 8) | (static_cast<uint64_t>(arg0) << 16) |
+               (static_cast<uint64_t>(static_cast<uint32_t>(arg1)) << 32);
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> next{0};
+
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+    JUCE_DECLARE_NON_COPYABLE(TraceRing)
+};
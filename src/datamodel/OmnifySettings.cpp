@@ -4,11 +4,16 @@ nlohmann::json OmnifySettings::to_json() const {
     nlohmann::json j;
     j["input"] = input;
     j["output"] = output;
+    j["directMode"] = directMode;
+    j["maxEventsPerBlock"] = maxEventsPerBlock;
     j["chordChannel"] = chordChannel;
     j["strumChannel"] = strumChannel;
     j["strumCooldownMs"] = strumCooldownMs;
     j["strumGateTimeMs"] = strumGateTimeMs;
     j["strumPlateCC"] = strumPlateCC;
+    j["strumPlate"] = strumPlate;
+    j["maxStrumVoices"] = maxStrumVoices;
+    j["strumVoiceStealing"] = strumVoiceStealing;
     j["chordVoicingStyle"] = chordVoicingTypeFor(chordVoicingStyle);
     j["strumVoicingStyle"] = strumVoicingTypeFor(strumVoicingStyle);
     j["voicingModifier"] = voicingModifier;
@@ -23,11 +28,16 @@ OmnifySettings OmnifySettings::from_json(const nlohmann::json& j) {
 
     settings.input = j.at("input").get<DawOrDevice>();
     settings.output = j.at("output").get<DawOrDevice>();
+    settings.directMode = j.value("directMode", false);  // added after settings_v2 shipped
+    settings.maxEventsPerBlock = j.value("maxEventsPerBlock", OmnifySettings().maxEventsPerBlock);
     settings.chordChannel = j.at("chordChannel").get<int>();
     settings.strumChannel = j.at("strumChannel").get<int>();
     settings.strumCooldownMs = j.at("strumCooldownMs").get<int>();
     settings.strumGateTimeMs = j.at("strumGateTimeMs").get<int>();
     settings.strumPlateCC = j.at("strumPlateCC").get<int>();
+    settings.strumPlate = j.value("strumPlate", StrumPlate());  // added after settings_v2 shipped
+    settings.maxStrumVoices = j.value("maxStrumVoices", 0);
+    settings.strumVoiceStealing = j.value("strumVoiceStealing", VoiceStealing::OLDEST);
 
     auto chordType = j.at("chordVoicingStyle").get<ChordVoicingType>();
     auto strumType = j.at("strumVoicingStyle").get<StrumVoicingType>();
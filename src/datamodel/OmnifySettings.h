@@ -5,6 +5,8 @@
 #include "ChordQualitySelectionStyle.h"
 #include "DawOrDevice.h"
 #include "MidiButton.h"
+#include "StrumPlate.h"
+#include "VoiceStealing.h"
 #include "VoicingModifier.h"
 #include "VoicingType.h"
 
@@ -12,12 +14,20 @@ class OmnifySettings {
    public:
     DawOrDevice input = Daw{};
     DawOrDevice output = Daw{};
+    // Device in and device out only: handle midi on the input thread as it arrives instead of once per audio block
+    bool directMode = false;
+    // Controller floods: past this many events in one block, ccs other than buttons are dropped. 0 means no limit.
+    int maxEventsPerBlock = 512;
     int chordChannel = 1;
     int strumChannel = 2;
 
     int strumCooldownMs = 300;
     int strumGateTimeMs = 500;
     int strumPlateCC = 1;
+    StrumPlate strumPlate;
+    // Most strum notes sounding at once, 0 for no limit. Past it a sounding note is cut off to make room.
+    int maxStrumVoices = 0;
+    VoiceStealing strumVoiceStealing = VoiceStealing::OLDEST;
 
     const VoicingStyle<VoicingFor::Chord>* chordVoicingStyle = chordVoicings().at(ChordVoicingType::Omnichord);
     const VoicingStyle<VoicingFor::Strum>* strumVoicingStyle = strumVoicings().at(StrumVoicingType::Omnichord);
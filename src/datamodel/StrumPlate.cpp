@@ -0,0 +1,11 @@
+#include "StrumPlate.h"
+
+void to_json(nlohmann::json& j, const StrumPlate& plate) {
+    j = {{"zoneCount", plate.getZoneCount()}, {"deadZoneWidth", plate.getDeadZoneWidth()}, {"curve", plate.getCurve()}};
+}
+
+void from_json(const nlohmann::json& j, StrumPlate& plate) {
+    StrumPlate defaults;
+    plate = StrumPlate(j.value("zoneCount", defaults.getZoneCount()), j.value("deadZoneWidth", defaults.getDeadZoneWidth()),
+                       j.value("curve", defaults.getCurve()));
+}
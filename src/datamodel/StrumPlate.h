@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <json.hpp>
+
+// How the zone widths vary along the plate. Dead zones are always the same width.
+enum class StrumCurve {
+    LINEAR,      // every zone the same width
+    WIDER_LOW,   // zones narrow towards the top of the plate, the bottom zone ~3x as wide as the top one
+    WIDER_HIGH,  // the reverse
+};
+
+NLOHMANN_JSON_SERIALIZE_ENUM(StrumCurve, {
+    {StrumCurve::LINEAR, "LINEAR"},
+    {StrumCurve::WIDER_LOW, "WIDER_LOW"},
+    {StrumCurve::WIDER_HIGH, "WIDER_HIGH"},
+})
+
+// The strum plate layout: zoneCount zones separated by dead zones, compiled into a lookup table from cc value to zone
+// when constructed, so the audio thread never does any arithmetic per cc. Immutable; it swaps along with the rest of
+// the settings snapshot it lives in.
+// Layout: [zone0][dead][zone1][dead]...[dead][zoneN-1] (no dead zone after the last zone)
+class StrumPlate {
+   public:
+    static constexpr int CC_VALUES = 128;
+    static constexpr int MIN_ZONES = 1;
+    static constexpr int MAX_ZONES = 32;
+
+    // The zones a sweep passes through between two cc values, in the order it meets them: first, first + step, ...
+    struct Crossing {
+        int first = 0;
+        int count = 0;
+        int step = 1;
+    };
+
+    // Out of range arguments are clamped: the dead zones shrink if they would leave a zone less than one value wide
+    constexpr StrumPlate(int zoneCount = 13, int deadZoneWidth = 2, StrumCurve curve = StrumCurve::LINEAR)
+        : zoneCount(std::clamp(zoneCount, MIN_ZONES, MAX_ZONES)),
+          deadZoneWidth(this->zoneCount == 1 ? 0 : std::clamp(deadZoneWidth, 0, (CC_VALUES - this->zoneCount) / (this->zoneCount - 1))),
+          curve(curve),
+          layout(compile(this->zoneCount, this->deadZoneWidth, curve)) {}
+
+    // Zone index (0 to getZoneCount() - 1), or -1 if ccValue is in a dead zone. ccValue must be 0-127.
+    constexpr int zoneFor(int ccValue) const { return layout.zones[static_cast<size_t>(ccValue)]; }
+
+    // Which stretch of the plate ccValue is in, counting zones and dead zones alike, in order along the plate: zone z
+    // is 2z and the dead zone after it 2z + 1. Unlike zoneFor, every dead zone is told apart. ccValue must be 0-127.
+    constexpr int regionFor(int ccValue) const {
+        auto value = static_cast<size_t>(ccValue);
+        return layout.zones[value] >= 0 ? 2 * layout.zones[value] : 2 * layout.zonesBelow[value] + 1;
+    }
+
+    // Zones swept over going from one cc value to the next, not counting the zone either end is in: the one it left
+    // was already played, and the one it lands in is zoneFor(toCc). Both values must be 0-127.
+    constexpr Crossing zonesCrossed(int fromCc, int toCc) const {
+        auto from = static_cast<size_t>(fromCc);
+        auto to = static_cast<size_t>(toCc);
+        if (toCc > fromCc) {
+            int first = layout.zonesBelow[from] + 1;
+            int last = layout.zones[to] >= 0 ? layout.zones[to] - 1 : layout.zonesBelow[to];
+            return {first, std::max(0, last - first + 1), 1};
+        }
+        if (toCc < fromCc) {
+            int first = layout.zones[from] >= 0 ? layout.zones[from] - 1 : layout.zonesBelow[from];
+            int last = layout.zones[to] >= 0 ? layout.zones[to] + 1 : layout.zonesBelow[to] + 1;
+            return {first, std::max(0, first - last + 1), -1};
+        }
+        return {};
+    }
+
+    // The cc value where a sweep enters zone: its lowest value going up, its highest going down
+    constexpr int entryValue(int zone, bool upward) const {
+        return upward ? layout.firstValues[static_cast<size_t>(zone)] : layout.lastValues[static_cast<size_t>(zone)];
+    }
+
+    constexpr int getZoneCount() const { return zoneCount; }
+    constexpr int getDeadZoneWidth() const { return deadZoneWidth; }
+    constexpr StrumCurve getCurve() const { return curve; }
+
+    constexpr bool operator==(const StrumPlate& other) const {
+        return zoneCount == other.zoneCount && deadZoneWidth == other.deadZoneWidth && curve == other.curve;
+    }
+
+   private:
+    // Where zone `boundary` starts, ignoring the dead zones: live * warp(boundary / zoneCount), in integers so the
+    // table is exact
+    static constexpr int boundaryOf(int boundary, int zoneCount, int live, StrumCurve curve) {
+        const int n = boundary;
+        const int d = zoneCount;
+        switch (curve) {
+            case StrumCurve::WIDER_LOW:  // p + p(1 - p) / 2
+                return live * n * (3 * d - n) / (2 * d * d);
+            case StrumCurve::WIDER_HIGH:  // p - p(1 - p) / 2
+                return live * n * (d + n) / (2 * d * d);
+            case StrumCurve::LINEAR:
+                break;
+        }
+        return live * n / d;
+    }
+
+    struct Layout {
+        std::array<int8_t, CC_VALUES> zones{};       // -1 in dead zones
+        std::array<int8_t, CC_VALUES> zonesBelow{};  // the zone at or below each value: in a dead zone, the one before it
+        std::array<uint8_t, MAX_ZONES> firstValues{};
+        std::array<uint8_t, MAX_ZONES> lastValues{};
+    };
+
+    static constexpr Layout compile(int zoneCount, int deadZoneWidth, StrumCurve curve) {
+        Layout layout;
+        const int live = CC_VALUES - (zoneCount - 1) * deadZoneWidth;
+
+        int cc = 0;
+        int start = 0;
+        for (int zone = 0; zone < zoneCount; zone++) {
+            int end = live;
+            if (zone < zoneCount - 1) {
+                // At least one value per zone, and enough left over for the zones after this one
+                end = boundaryOf(zone + 1, zoneCount, live, curve);
+                end = std::clamp(end, start + 1, live - (zoneCount - zone - 1));
+            }
+            layout.firstValues[static_cast<size_t>(zone)] = static_cast<uint8_t>(cc);
+            for (int i = start; i < end; i++) {
+                layout.zonesBelow[static_cast<size_t>(cc)] = static_cast<int8_t>(zone);
+                layout.zones[static_cast<size_t>(cc++)] = static_cast<int8_t>(zone);
+            }
+            layout.lastValues[static_cast<size_t>(zone)] = static_cast<uint8_t>(cc - 1);
+            if (zone < zoneCount - 1) {
+                for (int i = 0; i < deadZoneWidth; i++) {
+                    layout.zonesBelow[static_cast<size_t>(cc)] = static_cast<int8_t>(zone);
+                    layout.zones[static_cast<size_t>(cc++)] = -1;
+                }
+            }
+            start = end;
+        }
+        return layout;
+    }
+
+    int zoneCount;
+    int deadZoneWidth;
+    StrumCurve curve;
+    Layout layout;
+};
+
+// The default plate is the original layout: 13 zones 8 values wide, with 2 value dead zones between them
+static_assert(StrumPlate().zoneFor(0) == 0 && StrumPlate().zoneFor(7) == 0 && StrumPlate().zoneFor(8) == -1 && StrumPlate().zoneFor(10) == 1);
+static_assert(StrumPlate().zoneFor(119) == -1 && StrumPlate().zoneFor(120) == 12 && StrumPlate().zoneFor(127) == 12);
+static_assert(StrumPlate().regionFor(8) == 1 && StrumPlate().regionFor(18) == 3 && StrumPlate().regionFor(127) == 24);
+static_assert(StrumPlate(32, 2).zoneFor(127) == 31 && StrumPlate(32, 8).getDeadZoneWidth() == 3);
+
+// Sweeping 0 -> 127 crosses zones 1-11 and lands in 12; 127 -> 9 (a dead zone) crosses 11 down to 1
+static_assert(StrumPlate().zonesCrossed(0, 127).first == 1 && StrumPlate().zonesCrossed(0, 127).count == 11);
+static_assert(StrumPlate().zonesCrossed(127, 9).first == 11 && StrumPlate().zonesCrossed(127, 9).count == 11);
+static_assert(StrumPlate().zonesCrossed(10, 17).count == 0 && StrumPlate().entryValue(1, false) == 17);
+
+void to_json(nlohmann::json& j, const StrumPlate& plate);
+void from_json(const nlohmann::json& j, StrumPlate& plate);
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <json.hpp>
+
+// Which sounding strum note makes way when a new one would go over the strum polyphony limit
+enum class VoiceStealing { OLDEST, QUIETEST };
+
+NLOHMANN_JSON_SERIALIZE_ENUM(VoiceStealing, {
+    {VoiceStealing::OLDEST, "OLDEST"},
+    {VoiceStealing::QUIETEST, "QUIETEST"},
+})
@@ -1,12 +1,19 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "ChordQuality.h"
+#include "VoicingTable.h"
 
 enum class VoicingFor { Chord, Strum };
 
+template <VoicingFor T>
+using VoicingTableFor = std::conditional_t<T == VoicingFor::Chord, ChordVoicingTable, StrumVoicingTable>;
+
 // Abstract base class for voicing styles.
 template <VoicingFor T>
 class VoicingStyle {
@@ -15,4 +22,21 @@ class VoicingStyle {
     virtual std::string displayName() const = 0;
     virtual std::string description() const = 0;
     virtual std::vector<int> constructChord(ChordQuality quality, int root) const = 0;
+
+    // Every result of constructChord, so the audio thread does a lookup instead of a virtual call + allocation.
+    // Built on first use. The registries in VoicingType.h precompute() every style they hand out, so for those it's
+    // already built before any settings reach the audio thread.
+    const VoicingTableFor<T>& table() const {
+        std::call_once(tableBuilt, [this]() {
+            precomputedTable =
+                std::make_unique<const VoicingTableFor<T>>([this](ChordQuality quality, int root) { return constructChord(quality, root); });
+        });
+        return *precomputedTable;
+    }
+
+    void precompute() const { table(); }
+
+   private:
+    mutable std::once_flag tableBuilt;
+    mutable std::unique_ptr<const VoicingTableFor<T>> precomputedTable;
 };
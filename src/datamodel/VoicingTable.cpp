@@ -0,0 +1,77 @@
+#include "VoicingTable.h"
+
+#include <algorithm>
+
+namespace {
+
+int clampNote(int note) { return std::clamp(note, 0, 127); }
+
+// Octaves further from the middle use lower / higher inversions instead of shifting the whole chord.
+// Expects notes voiced around the root moved into the middle octave.
+void smooth(std::vector<int>& notes, int root) {
+    std::sort(notes.begin(), notes.end());
+    int octave = root / 12;
+
+    // octave 5 is the middle octave: 2-4 move the top 3-1 notes down, 6-8 move the bottom 1-3 notes up
+    size_t shiftDown = (octave >= 2 && octave <= 4) ? static_cast<size_t>(5 - octave) : 0;
+    size_t shiftUp = (octave >= 6 && octave <= 8) ? static_cast<size_t>(octave - 5) : 0;
+
+    for (size_t i = 0; i < shiftDown && i < notes.size(); i++) {
+        notes[notes.size() - 1 - i] -= 12;
+    }
+    for (size_t i = 0; i < shiftUp && i < notes.size(); i++) {
+        notes[i] += 12;
+    }
+}
+
+std::vector<int> applyModifier(const ConstructChordFn& constructChord, ChordQuality quality, int root, VoicingModifier modifier) {
+    switch (modifier) {
+        case VoicingModifier::NONE:
+            return constructChord(quality, root);
+        case VoicingModifier::FIXED:
+            return constructChord(quality, 60 + (root % 12));
+        case VoicingModifier::SMOOTH: {
+            auto notes = constructChord(quality, 60 + (root % 12));
+            smooth(notes, root);
+            return notes;
+        }
+    }
+    return {};
+}
+
+}  // namespace
+
+ChordVoicingTable::ChordVoicingTable(const ConstructChordFn& constructChord) {
+    for (auto modifier : {VoicingModifier::FIXED, VoicingModifier::NONE, VoicingModifier::SMOOTH}) {
+        for (auto quality : ALL_CHORD_QUALITIES) {
+            for (int root = 0; root < static_cast<int>(MIDI_NOTE_COUNT); root++) {
+                auto& voicing = entries[indexOf(quality, root, modifier)];
+
+                for (int note : applyModifier(constructChord, quality, root, modifier)) {
+                    if (voicing.count >= ChordVoicing::MAX_NOTES) {
+                        break;
+                    }
+                    auto clamped = static_cast<int8_t>(clampNote(note));
+                    if (std::find(voicing.begin(), voicing.end(), clamped) == voicing.end()) {
+                        voicing.notes[voicing.count++] = clamped;
+                    }
+                }
+            }
+        }
+    }
+}
+
+StrumVoicingTable::StrumVoicingTable(const ConstructChordFn& constructChord) {
+    for (auto quality : ALL_CHORD_QUALITIES) {
+        for (int root = 0; root < static_cast<int>(MIDI_NOTE_COUNT); root++) {
+            auto& voicing = entries[indexOf(quality, root)];
+
+            for (int note : constructChord(quality, root)) {
+                if (voicing.count >= StrumVoicing::MAX_NOTES || note > 127) {
+                    break;
+                }
+                voicing.notes[voicing.count++] = static_cast<int8_t>(clampNote(note));
+            }
+        }
+    }
+}
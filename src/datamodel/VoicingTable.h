@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "ChordQuality.h"
+#include "StrumPlate.h"
+#include "VoicingModifier.h"
+
+// The signature of VoicingStyle::constructChord, used to fill the tables below
+using ConstructChordFn = std::function<std::vector<int>(ChordQuality quality, int root)>;
+
+// A precomputed voicing, with notes already clamped to 0-127
+template <size_t N>
+struct Voicing {
+    static constexpr size_t MAX_NOTES = N;
+
+    std::array<int8_t, N> notes{};
+    uint8_t count = 0;
+
+    const int8_t* begin() const { return notes.data(); }
+    const int8_t* end() const { return notes.data() + count; }
+};
+
+// Chord voicings are also de-duplicated, since clamping can fold several notes onto 0 or 127
+using ChordVoicing = Voicing<8>;
+
+// One note per strum plate zone, for the longest plate. Layouts that run past note 127 stop there, so the zones above
+// them are silent.
+using StrumVoicing = Voicing<StrumPlate::MAX_ZONES>;
+
+inline constexpr size_t MIDI_NOTE_COUNT = 128;
+
+// Every chord a VoicingStyle<VoicingFor::Chord> can produce, for each quality, root and modifier.
+// Roots must be valid midi note numbers (0-127).
+class ChordVoicingTable {
+   public:
+    // Every voicing for one modifier, for code that settles on the modifier up front
+    class Slice {
+       public:
+        Slice() = default;
+        explicit Slice(const ChordVoicing* entries) : entries(entries) {}
+
+        const ChordVoicing& get(ChordQuality quality, int root) const {
+            return entries[static_cast<size_t>(quality) * MIDI_NOTE_COUNT + static_cast<size_t>(root)];
+        }
+
+       private:
+        const ChordVoicing* entries = nullptr;
+    };
+
+    explicit ChordVoicingTable(const ConstructChordFn& constructChord);
+
+    const ChordVoicing& get(ChordQuality quality, int root, VoicingModifier modifier) const { return entries[indexOf(quality, root, modifier)]; }
+    Slice slice(VoicingModifier modifier) const { return Slice(&entries[indexOf(ChordQuality::MAJOR, 0, modifier)]); }
+
+   private:
+    static constexpr size_t MODIFIER_COUNT = 3;
+
+    // Modifier-major, so each modifier's voicings are one contiguous Slice
+    static size_t indexOf(ChordQuality quality, int root, VoicingModifier modifier) {
+        return (static_cast<size_t>(modifier) * ALL_CHORD_QUALITIES.size() + static_cast<size_t>(quality)) * MIDI_NOTE_COUNT +
+               static_cast<size_t>(root);
+    }
+
+    std::array<ChordVoicing, MODIFIER_COUNT * ALL_CHORD_QUALITIES.size() * MIDI_NOTE_COUNT> entries;
+};
+
+// Every strum layout a VoicingStyle<VoicingFor::Strum> can produce, for each quality and root.
+// Roots must be valid midi note numbers (0-127).
+class StrumVoicingTable {
+   public:
+    explicit StrumVoicingTable(const ConstructChordFn& constructChord);
+
+    const StrumVoicing& get(ChordQuality quality, int root) const { return entries[indexOf(quality, root)]; }
+
+   private:
+    static size_t indexOf(ChordQuality quality, int root) { return static_cast<size_t>(quality) * MIDI_NOTE_COUNT + static_cast<size_t>(root); }
+
+    std::array<StrumVoicing, ALL_CHORD_QUALITIES.size() * MIDI_NOTE_COUNT> entries;
+};
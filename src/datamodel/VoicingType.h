@@ -1,7 +1,9 @@
 #pragma once
 
+#include <initializer_list>
 #include <json.hpp>
 #include <map>
+#include <utility>
 
 #include "../voicing_styles/Omni84.h"
 #include "../voicing_styles/OmnichordChords.h"
@@ -15,18 +17,29 @@ enum class ChordVoicingType { Omnichord, RootPosition, Omni84, SmoothedFull };
 
 enum class StrumVoicingType { Omnichord, PlainAscending };
 
+// Builds a registry, precomputing each style's lookup table on the way in
+template <typename Key, VoicingFor T>
+std::map<Key, const VoicingStyle<T>*> precomputedVoicings(std::initializer_list<std::pair<const Key, VoicingStyle<T>*>> styles) {
+    std::map<Key, const VoicingStyle<T>*> map;
+    for (const auto& [key, style] : styles) {
+        style->precompute();
+        map.emplace(key, style);
+    }
+    return map;
+}
+
 inline const std::map<ChordVoicingType, const VoicingStyle<VoicingFor::Chord>*>& chordVoicings() {
     static OmnichordChords omnichord;
     static RootPosition rootPosition;
     static Omni84 omni84;
     static SmoothedFull smoothedFull;
 
-    static const std::map<ChordVoicingType, const VoicingStyle<VoicingFor::Chord>*> map = {
+    static const auto map = precomputedVoicings<ChordVoicingType, VoicingFor::Chord>({
         {ChordVoicingType::Omnichord, &omnichord},
         {ChordVoicingType::RootPosition, &rootPosition},
         {ChordVoicingType::Omni84, &omni84},
         {ChordVoicingType::SmoothedFull, &smoothedFull},
-    };
+    });
     return map;
 }
 
@@ -34,10 +47,10 @@ inline const std::map<StrumVoicingType, const VoicingStyle<VoicingFor::Strum>*>&
     static OmnichordStrum omnichord;
     static PlainAscending plainAscending;
 
-    static const std::map<StrumVoicingType, const VoicingStyle<VoicingFor::Strum>*> map = {
+    static const auto map = precomputedVoicings<StrumVoicingType, VoicingFor::Strum>({
         {StrumVoicingType::Omnichord, &omnichord},
         {StrumVoicingType::PlainAscending, &plainAscending},
-    };
+    });
     return map;
 }
 
@@ -0,0 +1,123 @@
+#include "OfflineEngine.h"
+
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <cmath>
+#include <json.hpp>
+#include <stdexcept>
+
+OfflineEngine::OfflineEngine(std::shared_ptr<OmnifySettings> settings, double sampleRate)
+    : sampleRate(sampleRate), realtimeParams(std::make_shared<RealtimeParams>()), omnify(scheduler, std::move(settings), realtimeParams) {
+    scheduler.prepare(sampleRate);
+    omnify.setSampleRate(sampleRate);
+}
+
+bool OfflineEngine::processBlock(const juce::MidiBuffer& input, int numSamples, juce::MidiBuffer& output) {
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    omnify.getTrace().record(TraceRing::Kind::BLOCK_BEGIN, TraceRing::Track::AUDIO, 0, numSamples);
+    bool rewritten = omnify.processMidiBlock(input, currentSample, numSamples, output);
+    omnify.getTrace().record(TraceRing::Kind::BLOCK_END, TraceRing::Track::AUDIO, 0, (rewritten ? output : input).getNumEvents());
+    currentSample += numSamples;
+
+    auto elapsedSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    omnify.getStats().recordBlock(static_cast<int64_t>(elapsedSeconds * 1.0e9), static_cast<int64_t>(numSamples * 1.0e9 / sampleRate));
+    return rewritten;
+}
+
+std::vector<TimedMidiMessage> OfflineEngine::render(const std::vector<TimedMidiMessage>& input, int blockSize) {
+    std::vector<TimedMidiMessage> rendered;
+    juce::MidiBuffer in;
+    juce::MidiBuffer out;
+
+    size_t next = 0;
+    while (next < input.size() || !scheduler.isEmpty()) {
+        int64_t blockStart = currentSample;
+        in.clear();
+        out.clear();
+        while (next < input.size() && input[next].sample < blockStart + blockSize) {
+            in.addEvent(input[next].message, static_cast<int>(std::max<int64_t>(input[next].sample - blockStart, 0)));
+            next++;
+        }
+
+        bool rewritten = processBlock(in, blockSize, out);
+
+        for (const auto metadata : rewritten ? out : in) {
+            rendered.push_back({blockStart + metadata.samplePosition, metadata.getMessage()});
+        }
+    }
+    return rendered;
+}
+
+std::vector<TimedMidiMessage> readMidiFile(const juce::File& file, double sampleRate) {
+    juce::FileInputStream stream(file);
+    if (!stream.openedOk()) {
+        throw std::runtime_error("Can't open " + file.getFullPathName().toStdString());
+    }
+
+    juce::MidiFile midiFile;
+    if (!midiFile.readFrom(stream)) {
+        throw std::runtime_error("Not a Standard MIDI File: " + file.getFullPathName().toStdString());
+    }
+    midiFile.convertTimestampTicksToSeconds();
+
+    std::vector<TimedMidiMessage> events;
+    for (int t = 0; t < midiFile.getNumTracks(); t++) {
+        for (const auto* holder : *midiFile.getTrack(t)) {
+            const auto& msg = holder->message;
+            if (msg.isMetaEvent() || msg.isSysEx()) {
+                continue;
+            }
+            events.push_back({static_cast<int64_t>(std::llround(msg.getTimeStamp() * sampleRate)), msg});
+        }
+    }
+
+    std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.sample < b.sample; });
+    return events;
+}
+
+void writeMidiFile(const std::vector<TimedMidiMessage>& events, const juce::File& file, double sampleRate) {
+    constexpr int TICKS_PER_QUARTER_NOTE = 960;
+    constexpr int MICROSECONDS_PER_QUARTER_NOTE = 500000;  // 120bpm
+    constexpr double TICKS_PER_SECOND = TICKS_PER_QUARTER_NOTE * 1000000.0 / MICROSECONDS_PER_QUARTER_NOTE;
+
+    juce::MidiMessageSequence track;
+    track.addEvent(juce::MidiMessage::tempoMetaEvent(MICROSECONDS_PER_QUARTER_NOTE));
+    double lastTick = 0.0;
+    for (const auto& e : events) {
+        lastTick = std::round(static_cast<double>(e.sample) / sampleRate * TICKS_PER_SECOND);
+        auto msg = e.message;
+        msg.setTimeStamp(lastTick);
+        track.addEvent(msg);
+    }
+    auto endOfTrack = juce::MidiMessage::endOfTrack();
+    endOfTrack.setTimeStamp(lastTick);
+    track.addEvent(endOfTrack);
+    track.updateMatchedPairs();
+
+    juce::MidiFile midiFile;
+    midiFile.setTicksPerQuarterNote(TICKS_PER_QUARTER_NOTE);
+    midiFile.addTrack(track);
+
+    file.deleteFile();
+    juce::FileOutputStream stream(file);
+    if (!stream.openedOk() || !midiFile.writeTo(stream)) {
+        throw std::runtime_error("Can't write " + file.getFullPathName().toStdString());
+    }
+}
+
+std::shared_ptr<OmnifySettings> readSettingsFile(const juce::File& file) {
+    if (!file.existsAsFile()) {
+        throw std::runtime_error("Can't open " + file.getFullPathName().toStdString());
+    }
+    auto j = nlohmann::json::parse(file.loadFileAsString().toStdString());
+    return std::make_shared<OmnifySettings>(OmnifySettings::from_json(j));
+}
+
+juce::File fileForOption(const juce::ArgumentList& args, const juce::String& option) {
+    auto path = args.getValueForOption(option);
+    if (path.isEmpty()) {
+        throw std::runtime_error("Expected a filename after " + option.toStdString());
+    }
+    return juce::File::getCurrentWorkingDirectory().getChildFile(path.unquoted());
+}
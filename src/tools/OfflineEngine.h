@@ -0,0 +1,60 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "MidiMessageScheduler.h"
+#include "Omnify.h"
+#include "datamodel/OmnifySettings.h"
+
+// A midi message at an absolute sample position
+struct TimedMidiMessage {
+    int64_t sample;
+    juce::MidiMessage message;
+};
+
+/**
+ * Everything Omnify needs to run without a plugin host or editor.
+ * processBlock() does what OmnifyAudioProcessor::processBlock does for DAW in / DAW out.
+ */
+class OfflineEngine {
+   public:
+    OfflineEngine(std::shared_ptr<OmnifySettings> settings, double sampleRate);
+
+    // input positions are relative to the start of the block, as in a juce::MidiBuffer handed to processBlock.
+    // Like Omnify::processMidiBlock, returns false without touching output when input passes through unchanged.
+    // Block times and boundaries are recorded in getOmnify().getStats() and getTrace(), as the plugin does.
+    bool processBlock(const juce::MidiBuffer& input, int numSamples, juce::MidiBuffer& output);
+
+    // Runs a whole, time-sorted performance through processBlock in blocks of blockSize samples, as fast as possible,
+    // and keeps going after the last input until every scheduled note has been sent. Returns the output in order.
+    std::vector<TimedMidiMessage> render(const std::vector<TimedMidiMessage>& input, int blockSize);
+
+    int64_t getCurrentSample() const { return currentSample; }
+    double getSampleRate() const { return sampleRate; }
+    MidiMessageScheduler& getScheduler() { return scheduler; }
+    Omnify& getOmnify() { return omnify; }
+
+   private:
+    double sampleRate;
+    int64_t currentSample = 0;
+    MidiMessageScheduler scheduler;
+    std::shared_ptr<RealtimeParams> realtimeParams;
+    Omnify omnify;
+};
+
+// Every channel event from every track of a Standard MIDI File, merged and sorted by time. Throws on failure.
+std::vector<TimedMidiMessage> readMidiFile(const juce::File& file, double sampleRate);
+
+// Writes a single track Standard MIDI File at a fixed 120bpm, so sample positions survive the round trip. Throws on failure.
+void writeMidiFile(const std::vector<TimedMidiMessage>& events, const juce::File& file, double sampleRate);
+
+// Settings in the OmnifySettings::to_json format. Throws on failure.
+std::shared_ptr<OmnifySettings> readSettingsFile(const juce::File& file);
+
+// The file named after option on the command line. Unlike ArgumentList::getExistingFileForOption, which throws juce's
+// ConsoleAppFailureCode, a missing name throws std::runtime_error, and a missing file is left to the readers above.
+juce::File fileForOption(const juce::ArgumentList& args, const juce::String& option);
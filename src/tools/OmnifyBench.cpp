@@ -0,0 +1,276 @@
+// omnify_bench: drives synthetic and recorded midi through the engine, block by block, for every voicing style and
+// modifier combination, and reports per-event cost, allocations per event and per-block latency percentiles.
+//
+//   omnify_bench [--seconds 10] [--sample-rate 48000] [--block-size 64] [--midi recording.mid] [--settings settings.json]
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "OfflineEngine.h"
+
+//==============================================================================
+// Allocation counting. Every allocation in the process goes through these, but only the ones made while a block is
+// being timed are reported.
+
+namespace {
+std::atomic<uint64_t> allocationCount{0};
+}
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+//==============================================================================
+// Workloads
+
+constexpr int STRUM_CC = 1;
+constexpr int FIRST_QUALITY_PAD_CC = 20;  // CCs 20-28 select the 9 chord qualities
+
+struct Workload {
+    std::string name;
+    std::vector<TimedMidiMessage> events;
+};
+
+int64_t secondsToSamples(double seconds, double sampleRate) { return static_cast<int64_t>(std::llround(seconds * sampleRate)); }
+
+// A new root every 100ms, with the quality changing every 400ms
+Workload chordChanges(double seconds, double sampleRate, std::mt19937& rng) {
+    Workload w{"chord-changes", {}};
+    std::uniform_int_distribution<int> roots(36, 84);
+    std::uniform_int_distribution<int> qualities(0, 8);
+    int previousRoot = -1;
+    for (int i = 0; i * 0.1 < seconds; i++) {
+        auto at = secondsToSamples(i * 0.1, sampleRate);
+        if (i % 4 == 0) {
+            w.events.push_back({at, juce::MidiMessage::controllerEvent(1, FIRST_QUALITY_PAD_CC + qualities(rng), 127)});
+        }
+        if (previousRoot >= 0) {
+            w.events.push_back({at, juce::MidiMessage::noteOff(1, previousRoot)});
+        }
+        previousRoot = roots(rng);
+        w.events.push_back({at, juce::MidiMessage::noteOn(1, previousRoot, static_cast<juce::uint8>(100))});
+    }
+    return w;
+}
+
+// Back and forth sweeps across the whole strum plate at ccRate messages per second, changing chord every 500ms
+Workload strumSweep(double seconds, double sampleRate, int ccRate, std::mt19937& rng) {
+    Workload w{"strum-sweep-" + std::to_string(ccRate / 1000) + "k", {}};
+    std::uniform_int_distribution<int> roots(48, 72);
+    int numCCs = static_cast<int>(seconds * ccRate);
+    int previousRoot = -1;
+    for (int i = 0; i < numCCs; i++) {
+        double t = static_cast<double>(i) / ccRate;
+        auto at = secondsToSamples(t, sampleRate);
+        if (i % (ccRate / 2) == 0) {
+            if (previousRoot >= 0) {
+                w.events.push_back({at, juce::MidiMessage::noteOff(1, previousRoot)});
+            }
+            previousRoot = roots(rng);
+            w.events.push_back({at, juce::MidiMessage::noteOn(1, previousRoot, static_cast<juce::uint8>(100))});
+        }
+        int phase = i % 254;
+        int value = phase < 127 ? phase : 254 - phase;
+        w.events.push_back({at, juce::MidiMessage::controllerEvent(1, STRUM_CC, value)});
+    }
+    return w;
+}
+
+// Quality pads hammered at 1kHz, with a new root every 50ms
+Workload qualityMashing(double seconds, double sampleRate, std::mt19937& rng) {
+    Workload w{"quality-mashing", {}};
+    std::uniform_int_distribution<int> roots(36, 84);
+    std::uniform_int_distribution<int> pads(0, 8);
+    int previousRoot = -1;
+    for (int i = 0; i * 0.001 < seconds; i++) {
+        auto at = secondsToSamples(i * 0.001, sampleRate);
+        w.events.push_back({at, juce::MidiMessage::controllerEvent(1, FIRST_QUALITY_PAD_CC + pads(rng), (i % 2) == 0 ? 127 : 0)});
+        if (i % 50 == 0) {
+            if (previousRoot >= 0) {
+                w.events.push_back({at, juce::MidiMessage::noteOff(1, previousRoot)});
+            }
+            previousRoot = roots(rng);
+            w.events.push_back({at, juce::MidiMessage::noteOn(1, previousRoot, static_cast<juce::uint8>(100))});
+        }
+    }
+    return w;
+}
+
+//==============================================================================
+// Running
+
+struct Result {
+    uint64_t eventsIn = 0;
+    uint64_t allocations = 0;
+    std::vector<int64_t> blockNanos;
+};
+
+Result run(const Workload& workload, std::shared_ptr<OmnifySettings> settings, double sampleRate, int blockSize) {
+    OfflineEngine engine(std::move(settings), sampleRate);
+
+    int64_t lastSample = workload.events.empty() ? 0 : workload.events.back().sample;
+    auto numBlocks = static_cast<size_t>(lastSample / blockSize + 1);
+
+    Result result;
+    result.blockNanos.reserve(numBlocks);
+
+    juce::MidiBuffer input;
+    juce::MidiBuffer output;
+    input.ensureSize(64 * 1024);
+    output.ensureSize(64 * 1024);
+
+    size_t next = 0;
+    for (size_t block = 0; block < numBlocks; block++) {
+        int64_t blockStart = engine.getCurrentSample();
+        input.clear();
+        output.clear();
+        while (next < workload.events.size() && workload.events[next].sample < blockStart + blockSize) {
+            input.addEvent(workload.events[next].message, static_cast<int>(workload.events[next].sample - blockStart));
+            next++;
+            result.eventsIn++;
+        }
+
+        auto allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        engine.processBlock(input, blockSize, output);
+        auto end = std::chrono::steady_clock::now();
+        result.allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+
+        result.blockNanos.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    return result;
+}
+
+double percentile(const std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    auto index = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size()))) - 1;
+    return static_cast<double>(sorted[std::min(index, sorted.size() - 1)]);
+}
+
+void report(const std::string& workload, const std::string& combo, Result& result) {
+    int64_t total = 0;
+    for (auto ns : result.blockNanos) {
+        total += ns;
+    }
+    std::sort(result.blockNanos.begin(), result.blockNanos.end());
+
+    double events = static_cast<double>(std::max<uint64_t>(result.eventsIn, 1));
+    std::printf("%-18s %-34s %9llu %10.1f %9.3f %9.0f %9.0f %9.0f %9.0f\n", workload.c_str(), combo.c_str(),
+                static_cast<unsigned long long>(result.eventsIn), static_cast<double>(total) / events, static_cast<double>(result.allocations) / events,
+                percentile(result.blockNanos, 0.5), percentile(result.blockNanos, 0.99), percentile(result.blockNanos, 0.999),
+                result.blockNanos.empty() ? 0.0 : static_cast<double>(result.blockNanos.back()));
+}
+
+std::shared_ptr<OmnifySettings> defaultBenchSettings() {
+    auto settings = std::make_shared<OmnifySettings>();
+    settings->strumPlateCC = STRUM_CC;
+    std::map<int, ChordQuality> pads;
+    for (size_t i = 0; i < ALL_CHORD_QUALITIES.size(); i++) {
+        pads[FIRST_QUALITY_PAD_CC + static_cast<int>(i)] = ALL_CHORD_QUALITIES[i];
+    }
+    settings->chordQualitySelectionStyle = ButtonPerChordQuality({}, pads);
+    return settings;
+}
+
+std::string modifierName(VoicingModifier m) {
+    switch (m) {
+        case VoicingModifier::FIXED:
+            return "FIXED";
+        case VoicingModifier::NONE:
+            return "NONE";
+        case VoicingModifier::SMOOTH:
+            return "SMOOTH";
+    }
+    return "?";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    if (args.containsOption("--help|-h")) {
+        std::printf("usage: omnify_bench [--seconds 10] [--sample-rate 48000] [--block-size 64] [--midi file.mid] [--settings file.json]\n");
+        return 0;
+    }
+
+    double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 10.0;
+    double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    int blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 64;
+
+    try {
+        if (sampleRate <= 0.0 || blockSize <= 0) {
+            throw std::runtime_error("--sample-rate and --block-size must be positive");
+        }
+
+        auto baseSettings = args.containsOption("--settings") ? readSettingsFile(fileForOption(args, "--settings")) : defaultBenchSettings();
+
+        std::mt19937 rng(1234);
+        std::vector<Workload> workloads;
+        workloads.push_back(chordChanges(seconds, sampleRate, rng));
+        for (int rate : {1000, 5000, 10000}) {
+            workloads.push_back(strumSweep(seconds, sampleRate, rate, rng));
+        }
+        workloads.push_back(qualityMashing(seconds, sampleRate, rng));
+        if (args.containsOption("--midi")) {
+            workloads.push_back({"recorded", readMidiFile(fileForOption(args, "--midi"), sampleRate)});
+        }
+
+        std::printf("%.0f Hz, %d sample blocks, block times in ns\n\n", sampleRate, blockSize);
+        std::printf("%-18s %-34s %9s %10s %9s %9s %9s %9s %9s\n", "workload", "chord / strum / modifier", "events", "ns/event", "allocs/ev", "p50",
+                    "p99", "p99.9", "max");
+
+        for (const auto& workload : workloads) {
+            for (const auto& [chordType, chordStyle] : chordVoicings()) {
+                for (const auto& [strumType, strumStyle] : strumVoicings()) {
+                    for (auto modifier : {VoicingModifier::NONE, VoicingModifier::FIXED, VoicingModifier::SMOOTH}) {
+                        auto settings = std::make_shared<OmnifySettings>(*baseSettings);
+                        settings->chordVoicingStyle = chordStyle;
+                        settings->strumVoicingStyle = strumStyle;
+                        settings->voicingModifier = modifier;
+
+                        auto result = run(workload, settings, sampleRate, blockSize);
+                        auto combo = chordStyle->displayName() + " / " + strumStyle->displayName() + " / " + modifierName(modifier);
+                        report(workload.name, combo, result);
+                    }
+                }
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "omnify_bench: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+// omnify_render: plays a Standard MIDI File through Omnify, faster than real time and without any audio or midi
+// devices, and writes what Omnify would have sent (chords, strums and passed-through messages) to a new MIDI file.
+//
+//   omnify_render input.mid output.mid [--settings settings.json] [--sample-rate 48000] [--block-size 64] [--stats]
+//                 [--trace trace.json]
+//
+// --stats prints the engine's hot path counters (block times, event rates, suppressed strums, scheduler depth).
+// --trace writes the last blocks' event timeline as Chrome trace JSON, for ui.perfetto.dev.
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_core/juce_core.h>
+
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+
+#include "OfflineEngine.h"
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    if (args.size() < 2 || args.containsOption("--help|-h")) {
+        std::printf("usage: omnify_render input.mid output.mid [--settings settings.json] [--sample-rate 48000] [--block-size 64] [--stats]\n"
+                    "                     [--trace trace.json]\n");
+        return args.size() < 2 ? 1 : 0;
+    }
+
+    double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    int blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 64;
+
+    try {
+        if (sampleRate <= 0.0 || blockSize <= 0) {
+            throw std::runtime_error("--sample-rate and --block-size must be positive");
+        }
+
+        auto settings = args.containsOption("--settings") ? readSettingsFile(fileForOption(args, "--settings")) : std::make_shared<OmnifySettings>();
+        auto input = readMidiFile(args[0].resolveAsFile(), sampleRate);
+
+        OfflineEngine engine(settings, sampleRate);
+        auto output = engine.render(input, blockSize);
+
+        writeMidiFile(output, args[1].resolveAsFile(), sampleRate);
+        std::printf("%zu events in, %zu events out, %.1f seconds\n", input.size(), output.size(),
+                    static_cast<double>(engine.getCurrentSample()) / sampleRate);
+        if (args.containsOption("--trace") && !engine.getOmnify().getTrace().writeChromeTrace(args.getFileForOption("--trace"))) {
+            throw std::runtime_error("Can't write " + args.getFileForOption("--trace").getFullPathName().toStdString());
+        }
+        if (args.containsOption("--stats")) {
+            std::printf("%s\n", engine.getOmnify().getStats().snapshot().toString().toRawUTF8());
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "omnify_render: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+// omnify_rt_harness: replays midi through OmnifyAudioProcessor::processBlock in a -DOMNIFY_RT_CHECK=ON build and
+// fails if anything allocated or locked a mutex inside it. Every violation is printed with its stack trace and also
+// written to the OmnifyLogger session log.
+//
+//   omnify_rt_harness [--midi recording.mid] [--settings settings.json] [--seconds 10] [--sample-rate 48000]
+//                     [--block-size 64]
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+
+#include "OfflineEngine.h"
+#include "OmnifyLogger.h"
+#include "PluginProcessor.h"
+#include "RealtimeChecker.h"
+
+static_assert(OMNIFY_RT_CHECK, "omnify_rt_harness needs -DOMNIFY_RT_CHECK=ON");
+
+namespace {
+
+// Chords every 250ms with back and forth strums across the plate between them
+std::vector<TimedMidiMessage> syntheticPerformance(double seconds, double sampleRate, int strumPlateCC) {
+    std::vector<TimedMidiMessage> events;
+    const int roots[] = {48, 53, 55, 57, 60, 62, 64, 65};
+    int previousRoot = -1;
+    for (int step = 0; step * 0.25 < seconds; step++) {
+        auto at = static_cast<int64_t>(step * 0.25 * sampleRate);
+        if (previousRoot >= 0) {
+            events.push_back({at, juce::MidiMessage::noteOff(1, previousRoot)});
+        }
+        previousRoot = roots[step % 8];
+        events.push_back({at, juce::MidiMessage::noteOn(1, previousRoot, static_cast<juce::uint8>(100))});
+
+        for (int i = 0; i < 64; i++) {
+            auto value = (step % 2 == 0) ? i * 2 : 127 - i * 2;
+            events.push_back({at + static_cast<int64_t>(i * 0.002 * sampleRate), juce::MidiMessage::controllerEvent(1, strumPlateCC, value)});
+        }
+    }
+    return events;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 10.0;
+    double sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    int blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 64;
+
+    juce::SharedResourcePointer<OmnifyLogger> logger;
+    size_t violations = 0;
+
+    try {
+        if (sampleRate <= 0.0 || blockSize <= 0) {
+            throw std::runtime_error("--sample-rate and --block-size must be positive");
+        }
+
+        auto processor = std::make_unique<OmnifyAudioProcessor>();
+        if (args.containsOption("--settings")) {
+            auto settings = readSettingsFile(fileForOption(args, "--settings"));
+            processor->modifySettings([&settings](OmnifySettings& s) { s = *settings; });
+        }
+
+        auto events = args.containsOption("--midi") ? readMidiFile(fileForOption(args, "--midi"), sampleRate)
+                                                    : syntheticPerformance(seconds, sampleRate, processor->getSettings()->strumPlateCC);
+
+        processor->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+
+        // Anything the setup above did off the audio thread doesn't count
+        rtcheck::reportViolations([](const juce::String&) {});
+
+        juce::AudioBuffer<float> audio(2, blockSize);
+        juce::MidiBuffer midi;
+        midi.ensureSize(64 * 1024);
+
+        int64_t lastSample = events.empty() ? 0 : events.back().sample;
+        size_t next = 0;
+        for (int64_t blockStart = 0; blockStart <= lastSample; blockStart += blockSize) {
+            midi.clear();
+            while (next < events.size() && events[next].sample < blockStart + blockSize) {
+                midi.addEvent(events[next].message, static_cast<int>(events[next].sample - blockStart));
+                next++;
+            }
+            processor->processBlock(audio, midi);
+        }
+
+        processor->releaseResources();
+        violations = rtcheck::reportViolations([&logger](const juce::String& report) {
+            std::printf("%s\n", report.toRawUTF8());
+            logger->log(report);
+        });
+
+        std::printf("%zu events, %zu real-time violations\n", events.size(), violations);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "omnify_rt_harness: %s\n", e.what());
+        return 2;
+    }
+
+    return violations == 0 ? 0 : 1;
+}
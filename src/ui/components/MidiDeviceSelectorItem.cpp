@@ -23,11 +23,11 @@ MidiDeviceSelectorComponent::MidiDeviceSelectorComponent() {
 
     refreshDeviceList();
 
-    // Poll for device changes every 2 seconds
-    startTimer(2000);
+    // The watcher tells us when devices come and go
+    deviceWatcher->addChangeListener(this);
 }
 
-MidiDeviceSelectorComponent::~MidiDeviceSelectorComponent() { stopTimer(); }
+MidiDeviceSelectorComponent::~MidiDeviceSelectorComponent() { deviceWatcher->removeChangeListener(this); }
 
 void MidiDeviceSelectorComponent::paint(juce::Graphics& g) {
     g.setColour(LcarsColors::africanViolet);
@@ -76,14 +76,7 @@ void MidiDeviceSelectorComponent::setSelectedDevice(const juce::String& deviceNa
 }
 
 void MidiDeviceSelectorComponent::refreshDeviceList() {
-    auto devices = juce::MidiInput::getAvailableDevices();
-
-    juce::StringArray newNames;
-    for (const auto& device : devices) {
-        if (!device.name.startsWith("Omnify")) {
-            newNames.add(device.name);
-        }
-    }
+    auto newNames = deviceWatcher->getSelectableInputNames();
 
     // Only update if the list changed
     if (newNames != deviceNames) {
@@ -105,7 +98,7 @@ void MidiDeviceSelectorComponent::refreshDeviceList() {
 
 void MidiDeviceSelectorComponent::setCaption(const juce::String& text) { captionLabel.setText(text, juce::dontSendNotification); }
 
-void MidiDeviceSelectorComponent::timerCallback() { refreshDeviceList(); }
+void MidiDeviceSelectorComponent::changeListenerCallback(juce::ChangeBroadcaster*) { refreshDeviceList(); }
 
 void MidiDeviceSelectorComponent::enableMidiDeviceInStandalone(const juce::String& deviceName) {
     // In standalone mode, the StandaloneFilterWindow handles MIDI device management.
@@ -5,10 +5,12 @@
 
 #include <functional>
 
+#include "../../MidiDeviceWatcher.h"
+
 /**
  * A ComboBox that displays available MIDI input devices.
  */
-class MidiDeviceSelectorComponent : public juce::Component, private juce::Timer {
+class MidiDeviceSelectorComponent : public juce::Component, private juce::ChangeListener {
    public:
     MidiDeviceSelectorComponent();
     ~MidiDeviceSelectorComponent() override;
@@ -22,14 +24,14 @@ class MidiDeviceSelectorComponent : public juce::Component, private juce::Timer
     /** Set the displayed device name. */
     void setSelectedDevice(const juce::String& deviceName);
 
-    /** Refresh the list of available MIDI devices. */
+    /** Refresh the list of available MIDI devices from the shared device watcher. */
     void refreshDeviceList();
 
     /** Set caption text. */
     void setCaption(const juce::String& text);
 
    private:
-    void timerCallback() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
 
     static void enableMidiDeviceInStandalone(const juce::String& deviceName);
 
@@ -37,6 +39,7 @@ class MidiDeviceSelectorComponent : public juce::Component, private juce::Timer
     juce::Label captionLabel;
     juce::StringArray deviceNames;
     juce::String currentDeviceName;
+    juce::SharedResourcePointer<MidiDeviceWatcher> deviceWatcher;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiDeviceSelectorComponent)
 };
@@ -52,6 +52,7 @@ MidiIOPanel::MidiIOPanel() {
         bool useDaw = outputDawToggle.getToggleState();
         outputPortCombo.setEnabled(!useDaw);
         outputPortCombo.setVisible(!useDaw);
+        directToggle.setVisible(!useDaw);
         resized();
         notifyOutputChanged();
     };
@@ -69,11 +70,24 @@ MidiIOPanel::MidiIOPanel() {
     outputPortCombo.onChange = [this]() { notifyOutputChanged(); };
     addAndMakeVisible(outputPortCombo);
 
+    // Direct mode toggle (hidden by default since DAW toggle is on)
+    directToggle.setColour(juce::ToggleButton::tickColourId, LcarsColors::orange);
+    directToggle.getProperties().set("onText", "Direct");
+    directToggle.getProperties().set("offText", "Per Block");
+    LcarsLookAndFeel::setToggleButtonFontSize(directToggle, LcarsLookAndFeel::fontSizeMiniscule);
+    directToggle.setVisible(false);
+    directToggle.onClick = [this]() {
+        if (onDirectModeChanged) {
+            onDirectModeChanged(directToggle.getToggleState());
+        }
+    };
+    addChildComponent(directToggle);
+
     refreshDeviceList();
-    startTimer(2000);
+    deviceWatcher->addChangeListener(this);
 }
 
-MidiIOPanel::~MidiIOPanel() { stopTimer(); }
+MidiIOPanel::~MidiIOPanel() { deviceWatcher->removeChangeListener(this); }
 
 void MidiIOPanel::paint(juce::Graphics& g) {
     auto bounds = getLocalBounds().toFloat();
@@ -158,6 +172,7 @@ void MidiIOPanel::resized() {
         // Port mode: two rows with smaller text
         const int rowHeight = 26;
         const int toggleWidth = 120;
+        const int directToggleWidth = 90;
         const int rowSpacing = 2;
 
         if (laf != nullptr) {
@@ -170,21 +185,17 @@ void MidiIOPanel::resized() {
         outputDawToggle.setBounds(outputTopRow);
 
         outputSection.removeFromTop(rowSpacing);
-        outputPortCombo.setBounds(outputSection.removeFromTop(rowHeight));
+        auto outputBottomRow = outputSection.removeFromTop(rowHeight);
+        directToggle.setBounds(outputBottomRow.removeFromRight(directToggleWidth));
+        outputBottomRow.removeFromRight(rowSpacing);
+        outputPortCombo.setBounds(outputBottomRow);
     }
 }
 
-void MidiIOPanel::timerCallback() { refreshDeviceList(); }
+void MidiIOPanel::changeListenerCallback(juce::ChangeBroadcaster*) { refreshDeviceList(); }
 
 void MidiIOPanel::refreshDeviceList() {
-    auto devices = juce::MidiInput::getAvailableDevices();
-
-    juce::StringArray newNames;
-    for (const auto& device : devices) {
-        if (!device.name.startsWith("Omnify")) {
-            newNames.add(device.name);
-        }
-    }
+    auto newNames = deviceWatcher->getSelectableInputNames();
 
     if (newNames != deviceNames) {
         deviceNames = newNames;
@@ -240,6 +251,7 @@ void MidiIOPanel::setOutputDaw(bool useDaw) {
     outputDawToggle.setToggleState(useDaw, juce::dontSendNotification);
     outputPortCombo.setEnabled(!useDaw);
     outputPortCombo.setVisible(!useDaw);
+    directToggle.setVisible(!useDaw);
     resized();
 }
 
@@ -252,3 +264,5 @@ void MidiIOPanel::setOutputPortName(const juce::String& portName) {
     }
     outputPortCombo.setSelectedId(1, juce::dontSendNotification);
 }
+
+void MidiIOPanel::setDirectMode(bool direct) { directToggle.setToggleState(direct, juce::dontSendNotification); }
@@ -5,7 +5,9 @@
 
 #include <functional>
 
-class MidiIOPanel : public juce::Component, private juce::Timer {
+#include "../../MidiDeviceWatcher.h"
+
+class MidiIOPanel : public juce::Component, private juce::ChangeListener {
    public:
     MidiIOPanel();
     ~MidiIOPanel() override;
@@ -15,14 +17,16 @@ class MidiIOPanel : public juce::Component, private juce::Timer {
 
     std::function<void(bool useDaw, const juce::String& deviceName)> onInputChanged;
     std::function<void(bool useDaw, const juce::String& portName)> onOutputChanged;
+    std::function<void(bool direct)> onDirectModeChanged;
 
     void setInputDaw(bool useDaw);
     void setInputDevice(const juce::String& deviceName);
     void setOutputDaw(bool useDaw);
     void setOutputPortName(const juce::String& portName);
+    void setDirectMode(bool direct);
 
    private:
-    void timerCallback() override;
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
     void refreshDeviceList();
     void notifyInputChanged();
     void notifyOutputChanged();
@@ -33,11 +37,13 @@ class MidiIOPanel : public juce::Component, private juce::Timer {
     juce::ComboBox inputDeviceCombo;
     juce::StringArray deviceNames;
     juce::String currentDeviceName;
+    juce::SharedResourcePointer<MidiDeviceWatcher> deviceWatcher;
 
     // Output side
     juce::Label outputLabel{"", "Output"};
     juce::ToggleButton outputDawToggle;
     juce::ComboBox outputPortCombo;
+    juce::ToggleButton directToggle;  // only takes effect when the input is a device too
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiIOPanel)
 };
@@ -7,14 +7,34 @@ MidiLearnComponent::MidiLearnComponent() { setWantsKeyboardFocus(true); }
 
 MidiLearnComponent::~MidiLearnComponent() {
     if (currentlyLearning.load() == this) {
+        learningActive.store(false);
         currentlyLearning.store(nullptr);
     }
 }
 
 void MidiLearnComponent::broadcastMidi(const juce::MidiMessage& message) {
-    auto* active = currentlyLearning.load();
-    if (active != nullptr) {
-        active->processMessage(message);
+    if (!learningActive.load(std::memory_order_relaxed) || !accepts(learningAcceptMode.load(std::memory_order_relaxed), message)) {
+        return;
+    }
+
+    // Only the first message after the mailbox was emptied gets in; learning stops at the first one anyway
+    const auto* data = message.getRawData();
+    uint32_t packed = MAILBOX_FULL | (static_cast<uint32_t>(data[0]) << 16) | (static_cast<uint32_t>(data[1]) << 8) | data[2];
+    uint32_t empty = 0;
+    learnMailbox.compare_exchange_strong(empty, packed, std::memory_order_release, std::memory_order_relaxed);
+}
+
+bool MidiLearnComponent::accepts(MidiAcceptMode mode, const juce::MidiMessage& msg) {
+    bool acceptNotes = mode == MidiAcceptMode::NotesOnly || mode == MidiAcceptMode::Both;
+    bool acceptCCs = mode == MidiAcceptMode::CCsOnly || mode == MidiAcceptMode::Both;
+    return (acceptNotes && msg.isNoteOn() && msg.getVelocity() > 0) || (acceptCCs && msg.isController());
+}
+
+void MidiLearnComponent::timerCallback() {
+    auto packed = learnMailbox.exchange(0, std::memory_order_acquire);
+    if (packed != 0) {
+        processMessage(juce::MidiMessage(static_cast<int>((packed >> 16) & 0xFF), static_cast<int>((packed >> 8) & 0xFF),
+                                         static_cast<int>(packed & 0xFF)));
     }
 }
 
@@ -31,37 +51,22 @@ void MidiLearnComponent::setAcceptMode(MidiAcceptMode mode) { acceptMode = mode;
 void MidiLearnComponent::setAspectRatio(float ratio) { aspectRatio = ratio; }
 
 void MidiLearnComponent::processMessage(const juce::MidiMessage& msg) {
-    if (!isLearning.load()) {
+    if (!isLearning.load() || !accepts(acceptMode, msg)) {
         return;
     }
 
-    bool acceptNotes = acceptMode == MidiAcceptMode::NotesOnly || acceptMode == MidiAcceptMode::Both;
-    bool acceptCCs = acceptMode == MidiAcceptMode::CCsOnly || acceptMode == MidiAcceptMode::Both;
-
-    if (acceptNotes && msg.isNoteOn() && msg.getVelocity() > 0) {
-        learnedType.store(MidiLearnedType::Note);
-        learnedValue.store(msg.getNoteNumber());
-        isLearning.store(false);
-        if (currentlyLearning.load() == this) {
-            currentlyLearning.store(nullptr);
-        }
-        triggerAsyncUpdate();
-        if (onValueChanged) {
-            onValueChanged({.type = MidiLearnedType::Note, .value = msg.getNoteNumber()});
-        }
-        return;
+    MidiLearnedValue learned;
+    if (msg.isNoteOn()) {
+        learned = {.type = MidiLearnedType::Note, .value = msg.getNoteNumber()};
+    } else {
+        learned = {.type = MidiLearnedType::CC, .value = msg.getControllerNumber()};
     }
-    if (acceptCCs && msg.isController()) {
-        learnedType.store(MidiLearnedType::CC);
-        learnedValue.store(msg.getControllerNumber());
-        isLearning.store(false);
-        if (currentlyLearning.load() == this) {
-            currentlyLearning.store(nullptr);
-        }
-        triggerAsyncUpdate();
-        if (onValueChanged) {
-            onValueChanged({.type = MidiLearnedType::CC, .value = msg.getControllerNumber()});
-        }
+
+    learnedType.store(learned.type);
+    learnedValue.store(learned.value);
+    stopLearning();
+    if (onValueChanged) {
+        onValueChanged(learned);
     }
 }
 
@@ -132,8 +137,6 @@ void MidiLearnComponent::mouseDown(const juce::MouseEvent& event) {
     }
 }
 
-void MidiLearnComponent::handleAsyncUpdate() { repaint(); }
-
 void MidiLearnComponent::startLearning() {
     auto* prev = currentlyLearning.load();
     if (prev != nullptr && prev != this) {
@@ -141,6 +144,12 @@ void MidiLearnComponent::startLearning() {
     }
     currentlyLearning.store(this);
     isLearning.store(true);
+
+    learnMailbox.store(0);
+    learningAcceptMode.store(acceptMode);
+    learningActive.store(true);
+    startTimer(MAILBOX_POLL_MS);
+
     grabKeyboardFocus();
     repaint();
 }
@@ -154,7 +163,9 @@ bool MidiLearnComponent::keyPressed(const juce::KeyPress& key) {
 }
 
 void MidiLearnComponent::stopLearning() {
+    stopTimer();
     if (currentlyLearning.load() == this) {
+        learningActive.store(false);
         currentlyLearning.store(nullptr);
     }
     isLearning.store(false);
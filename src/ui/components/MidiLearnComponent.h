@@ -5,6 +5,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
 
 enum class MidiLearnedType { None, Note, CC };
@@ -16,18 +17,23 @@ struct MidiLearnedValue {
     int value = -1;  // Note number or CC number
 };
 
-class MidiLearnComponent : public juce::Component, private juce::AsyncUpdater {
+class MidiLearnComponent : public juce::Component, private juce::Timer {
    public:
     MidiLearnComponent();
     ~MidiLearnComponent() override;
 
+    // Audio or midi input thread. While a component is learning, offers the message to it through a single-slot
+    // mailbox that the component's timer empties on the message thread; never blocks, allocates or calls out.
+    // When nobody is learning this is one relaxed atomic load.
     static void broadcastMidi(const juce::MidiMessage& message);
+    static bool isAnyoneLearning() { return learningActive.load(std::memory_order_relaxed); }
 
     void setLearnedValue(MidiLearnedValue val);
     MidiLearnedValue getLearnedValue() const;
     void setAcceptMode(MidiAcceptMode mode);
     void setAspectRatio(float ratio);
 
+    // Message thread
     void processMessage(const juce::MidiMessage& message);
 
     std::function<void(MidiLearnedValue)> onValueChanged;
@@ -38,20 +44,34 @@ class MidiLearnComponent : public juce::Component, private juce::AsyncUpdater {
     bool keyPressed(const juce::KeyPress& key) override;
 
    private:
-    void handleAsyncUpdate() override;
+    void timerCallback() override;
+    static bool accepts(MidiAcceptMode mode, const juce::MidiMessage& msg);
     static juce::String noteNumberToName(int noteNumber);
     juce::String getDisplayText() const;
     void startLearning();
     void stopLearning();
 
+    static constexpr int MAILBOX_POLL_MS = 20;
+    static constexpr uint32_t MAILBOX_FULL = 1U << 31;  // or'd with status << 16 | data1 << 8 | data2
+
     static inline std::atomic<MidiLearnComponent*> currentlyLearning{nullptr};
 
+    // Shared with broadcastMidi(). Written on the message thread by whichever component is learning.
+    static inline std::atomic<bool> learningActive{false};
+    static inline std::atomic<MidiAcceptMode> learningAcceptMode{MidiAcceptMode::Both};
+    static inline std::atomic<uint32_t> learnMailbox{0};  // 0 when empty
+
     std::atomic<MidiLearnedType> learnedType{MidiLearnedType::None};
     std::atomic<int> learnedValue{-1};
     std::atomic<bool> isLearning{false};
     MidiAcceptMode acceptMode{MidiAcceptMode::Both};
     float aspectRatio{0.0F};  // 0 means no constraint (width/height)
 
+    // broadcastMidi() runs on the audio thread, so these must never take a lock
+    static_assert(std::atomic<bool>::is_always_lock_free);
+    static_assert(std::atomic<MidiAcceptMode>::is_always_lock_free);
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+
     juce::Rectangle<int> boxBounds;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MidiLearnComponent)
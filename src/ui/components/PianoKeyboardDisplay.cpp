@@ -1,13 +1,39 @@
 #include "PianoKeyboardDisplay.h"
 
 void PianoKeyboardDisplay::setActiveNotes(const std::array<bool, 128>& notes) {
+    for (int note = startNote; note < endNote; note++) {
+        if (notes[static_cast<size_t>(note)] != activeNotes[static_cast<size_t>(note)]) {
+            repaint(getKeyBounds(note).getSmallestIntegerContainer());
+        }
+    }
     activeNotes = notes;
+}
+
+void PianoKeyboardDisplay::setHighlightColour(juce::Colour colour) {
+    highlightColour = colour;
     repaint();
 }
 
+void PianoKeyboardDisplay::setWhiteKeyColour(juce::Colour colour) {
+    whiteKeyColour = colour;
+    invalidateBackground();
+}
+
+void PianoKeyboardDisplay::setBlackKeyColour(juce::Colour colour) {
+    blackKeyColour = colour;
+    invalidateBackground();
+}
+
 void PianoKeyboardDisplay::setKeyRange(int start, int end) {
     startNote = start;
     endNote = end;
+    invalidateBackground();
+}
+
+void PianoKeyboardDisplay::resized() { invalidateBackground(); }
+
+void PianoKeyboardDisplay::invalidateBackground() {
+    background = {};
     repaint();
 }
 
@@ -26,58 +52,91 @@ int PianoKeyboardDisplay::countWhiteKeys() const {
     return count;
 }
 
-void PianoKeyboardDisplay::paint(juce::Graphics& g) {
+juce::Rectangle<float> PianoKeyboardDisplay::getKeyBounds(int note) const {
     auto bounds = getLocalBounds().toFloat();
     int numWhiteKeys = countWhiteKeys();
     if (numWhiteKeys == 0) {
-        return;
+        return {};
     }
 
     float whiteKeyWidth = bounds.getWidth() / static_cast<float>(numWhiteKeys);
     float blackKeyWidth = whiteKeyWidth * 0.6f;
     float blackKeyHeight = bounds.getHeight() * 0.6f;
 
-    // Draw white keys first
+    // Index of this key, or for a black key the white key before it
     int whiteKeyIndex = 0;
-    for (int note = startNote; note < endNote; note++) {
-        if (!isBlackKey(note)) {
-            float x = static_cast<float>(whiteKeyIndex) * whiteKeyWidth;
-            auto keyBounds = juce::Rectangle<float>(x, 0, whiteKeyWidth, bounds.getHeight());
-
-            // Fill
-            if (activeNotes[static_cast<size_t>(note)]) {
-                g.setColour(highlightColour);
-            } else {
-                g.setColour(whiteKeyColour);
-            }
-            g.fillRect(keyBounds);
+    for (int n = startNote; n < note; n++) {
+        if (!isBlackKey(n)) {
+            whiteKeyIndex++;
+        }
+    }
+
+    if (isBlackKey(note)) {
+        if (note == startNote) {
+            return {};  // no white key to sit on
+        }
+        float x = static_cast<float>(whiteKeyIndex) * whiteKeyWidth - blackKeyWidth / 2.0F;
+        return {x, 1.0F, blackKeyWidth, blackKeyHeight};
+    }
+    float x = static_cast<float>(whiteKeyIndex) * whiteKeyWidth;
+    return {x, 0, whiteKeyWidth, bounds.getHeight()};
+}
+
+void PianoKeyboardDisplay::paintKey(juce::Graphics& g, int note, bool active) const {
+    auto keyBounds = getKeyBounds(note);
+    if (isBlackKey(note)) {
+        g.setColour(active ? highlightColour : blackKeyColour);
+        g.fillRect(keyBounds);
+        return;
+    }
 
-            // Border
-            g.setColour(juce::Colours::black);
-            g.drawRect(keyBounds, 1.0F);
+    // Fill
+    g.setColour(active ? highlightColour : whiteKeyColour);
+    g.fillRect(keyBounds);
 
-            whiteKeyIndex++;
+    // Border
+    g.setColour(juce::Colours::black);
+    g.drawRect(keyBounds, 1.0F);
+}
+
+void PianoKeyboardDisplay::paint(juce::Graphics& g) {
+    if (getWidth() <= 0 || getHeight() <= 0 || countWhiteKeys() == 0) {
+        return;
+    }
+
+    // Redraw the unlit keyboard only when it's been invalidated or the display scale changed
+    auto scale = juce::Component::getApproximateScaleFactorForComponent(this);
+    if (!background.isValid() || scale != backgroundScale) {
+        backgroundScale = scale;
+        background = juce::Image(juce::Image::ARGB, juce::roundToInt(static_cast<float>(getWidth()) * scale),
+                                 juce::roundToInt(static_cast<float>(getHeight()) * scale), true);
+        juce::Graphics bg(background);
+        bg.addTransform(juce::AffineTransform::scale(scale));
+
+        // White keys first, black keys on top
+        for (int note = startNote; note < endNote; note++) {
+            if (!isBlackKey(note)) {
+                paintKey(bg, note, false);
+            }
+        }
+        for (int note = startNote; note < endNote; note++) {
+            if (isBlackKey(note)) {
+                paintKey(bg, note, false);
+            }
         }
     }
+    g.drawImage(background, getLocalBounds().toFloat());
 
-    // Draw black keys on top
-    whiteKeyIndex = 0;
+    // Then the lit white keys, and every black key in the dirty region, since a lit white key paints over its neighbours
+    auto clip = g.getClipBounds().toFloat();
     for (int note = startNote; note < endNote; note++) {
-        if (!isBlackKey(note)) {
-            // Check if next note is a black key
-            if (note + 1 < endNote && isBlackKey(note + 1)) {
-                float x = (static_cast<float>(whiteKeyIndex) + 1.0F) * whiteKeyWidth - blackKeyWidth / 2.0F;
-                auto keyBounds = juce::Rectangle<float>(x, 1.0F, blackKeyWidth, blackKeyHeight);
-
-                // Fill
-                if (activeNotes[static_cast<size_t>(note + 1)]) {
-                    g.setColour(highlightColour);
-                } else {
-                    g.setColour(blackKeyColour);
-                }
-                g.fillRect(keyBounds);
-            }
-            whiteKeyIndex++;
+        if (!isBlackKey(note) && activeNotes[static_cast<size_t>(note)] && getKeyBounds(note).intersects(clip)) {
+            paintKey(g, note, true);
+        }
+    }
+    for (int note = startNote; note < endNote; note++) {
+        if (isBlackKey(note) && getKeyBounds(note).intersects(clip)) {
+            paintKey(g, note, activeNotes[static_cast<size_t>(note)]);
         }
     }
 }
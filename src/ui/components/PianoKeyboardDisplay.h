@@ -4,16 +4,19 @@
 
 #include <array>
 
+// The unlit keyboard is drawn once into a cached image; paints after that blit it and draw only the lit keys, and
+// setActiveNotes() only repaints the keys that changed.
 class PianoKeyboardDisplay : public juce::Component {
    public:
     PianoKeyboardDisplay() = default;
 
     void paint(juce::Graphics& g) override;
+    void resized() override;
 
     void setActiveNotes(const std::array<bool, 128>& notes);
-    void setHighlightColour(juce::Colour colour) { highlightColour = colour; }
-    void setWhiteKeyColour(juce::Colour colour) { whiteKeyColour = colour; }
-    void setBlackKeyColour(juce::Colour colour) { blackKeyColour = colour; }
+    void setHighlightColour(juce::Colour colour);
+    void setWhiteKeyColour(juce::Colour colour);
+    void setBlackKeyColour(juce::Colour colour);
     void setKeyRange(int startNote, int endNote);
 
    private:
@@ -27,8 +30,14 @@ class PianoKeyboardDisplay : public juce::Component {
     juce::Colour whiteKeyColour{juce::Colours::white};
     juce::Colour blackKeyColour{juce::Colours::black};
 
+    juce::Image background;  // every key unlit, at backgroundScale; invalid when it needs redrawing
+    float backgroundScale = 1.0F;
+
     static bool isBlackKey(int note);
     int countWhiteKeys() const;
+    juce::Rectangle<float> getKeyBounds(int note) const;
+    void paintKey(juce::Graphics& g, int note, bool active) const;
+    void invalidateBackground();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PianoKeyboardDisplay)
 };
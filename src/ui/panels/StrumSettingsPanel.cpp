@@ -45,6 +45,16 @@ StrumSettingsPanel::StrumSettingsPanel(OmnifyAudioProcessor& p) : processor(p) {
     strumPlateCcLearn.setAcceptMode(MidiAcceptMode::CCsOnly);
     addAndMakeVisible(strumPlateCcLearn);
 
+    // Strum Plate zones
+    zonesLabel.setColour(juce::Label::textColourId, LcarsColors::africanViolet);
+    zonesLabel.setJustificationType(juce::Justification::centredLeft);
+    addAndMakeVisible(zonesLabel);
+
+    for (int i = StrumPlate::MIN_ZONES; i <= StrumPlate::MAX_ZONES; ++i) {
+        zonesComboBox.addItem(juce::String(i), i);
+    }
+    addAndMakeVisible(zonesComboBox);
+
     // Sliders
     gateLabel.setColour(juce::Label::textColourId, LcarsColors::africanViolet);
     gateLabel.setJustificationType(juce::Justification::centredLeft);
@@ -93,6 +103,13 @@ void StrumSettingsPanel::setupCallbacks() {
         });
     };
 
+    // Strum Plate zones: keeps the dead zone width and curve, which the plate shrinks if they no longer fit
+    zonesComboBox.onChange = [this]() {
+        processor.modifySettings([zones = zonesComboBox.getSelectedId()](OmnifySettings& s) {
+            s.strumPlate = StrumPlate(zones, s.strumPlate.getDeadZoneWidth(), s.strumPlate.getCurve());
+        });
+    };
+
     // APVTS slider attachments (these remain as APVTS for real-time automation)
     gateAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "strum_gate_time_ms", gateSlider);
     cooldownAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(apvts, "strum_cooldown_ms", cooldownSlider);
@@ -112,6 +129,9 @@ void StrumSettingsPanel::refreshFromSettings() {
     }
     strumPlateCcLearn.setLearnedValue(strumVal);
 
+    // Strum Plate zones
+    zonesComboBox.setSelectedId(settings->strumPlate.getZoneCount(), juce::dontSendNotification);
+
     // Voicing style selector - find matching index
     if (settings->strumVoicingStyle) {
         auto currentType = strumVoicingTypeFor(settings->strumVoicingStyle);
@@ -151,6 +171,7 @@ void StrumSettingsPanel::resized() {
         voicingLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeSmall));
         voicingDescriptionLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeTiny));
         strumPlateLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeSmall));
+        zonesLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeSmall));
         gateLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeSmall));
         cooldownLabel.setFont(laf->getOrbitronFont(LcarsLookAndFeel::fontSizeSmall));
     }
@@ -173,7 +194,7 @@ void StrumSettingsPanel::resized() {
     voicingLabel.setBounds(bounds.removeFromTop(24));
     bounds.removeFromTop(4);
 
-    // Bottom section: 3 rows aligned to bottom (remove these first so selector gets remaining space)
+    // Bottom section: 4 rows aligned to bottom (remove these first so selector gets remaining space)
     // Cooldown row
     auto cooldownRowBounds = bounds.removeFromBottom(LcarsLookAndFeel::rowHeight);
     cooldownSlider.setBounds(cooldownRowBounds.removeFromRight(LcarsLookAndFeel::capsuleWidth));
@@ -186,6 +207,13 @@ void StrumSettingsPanel::resized() {
     gateLabel.setBounds(gateRowBounds);
     bounds.removeFromBottom(4);
 
+    // Zones row
+    LcarsLookAndFeel::setComboBoxFontSize(zonesComboBox, LcarsLookAndFeel::fontSizeSmall);
+    auto zonesRowBounds = bounds.removeFromBottom(LcarsLookAndFeel::rowHeight);
+    zonesComboBox.setBounds(zonesRowBounds.removeFromRight(LcarsLookAndFeel::capsuleWidth));
+    zonesLabel.setBounds(zonesRowBounds);
+    bounds.removeFromBottom(4);
+
     // Strum CC row
     auto strumCcRowBounds = bounds.removeFromBottom(LcarsLookAndFeel::rowHeight);
     strumPlateCcLearn.setBounds(strumCcRowBounds.removeFromRight(LcarsLookAndFeel::capsuleWidth));
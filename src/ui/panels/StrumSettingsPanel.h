@@ -41,6 +41,10 @@ class StrumSettingsPanel : public juce::Component {
     juce::Label strumPlateLabel{"", "Strum CC"};
     MidiLearnComponent strumPlateCcLearn;
 
+    // Strum Plate zones. Dead zone width and curve are only in the settings file for now.
+    juce::Label zonesLabel{"", "Zones"};
+    juce::ComboBox zonesComboBox;
+
     // Gate and Cooldown sliders
     juce::Slider gateSlider{juce::Slider::LinearBar, juce::Slider::NoTextBox};
     juce::Slider cooldownSlider{juce::Slider::LinearBar, juce::Slider::NoTextBox};
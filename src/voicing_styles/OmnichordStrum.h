@@ -19,9 +19,11 @@ class OmnichordStrum : public VoicingStyle<VoicingFor::Strum> {
     std::vector<int> constructChord(ChordQuality quality, int root) const override {
         const auto& triad = getChordQualityData(quality).triadOffsets;
         std::vector<int> res;
-        res.reserve(15);
+        res.reserve(StrumVoicing::MAX_NOTES);
         int rootOctaveStart = findLowestFSharp(root);
-        for (int o : {-12, 0, 12, 24, 36}) {
+
+        // Enough octaves for the longest plate; a standard 13 zone plate uses the first 13 notes
+        for (int o = -12; res.size() < StrumVoicing::MAX_NOTES; o += 12) {
             int thisOctaveStart = rootOctaveStart + o;
             for (int offset : triad) {
                 int note = root + offset;
@@ -29,8 +31,7 @@ class OmnichordStrum : public VoicingStyle<VoicingFor::Strum> {
             }
         }
 
-        // We only need 13 notes not 15
-        res.resize(13);
+        res.resize(StrumVoicing::MAX_NOTES);
         return res;
     }
 
@@ -17,15 +17,15 @@ class PlainAscending : public VoicingStyle<VoicingFor::Strum> {
     std::vector<int> constructChord(ChordQuality quality, int root) const override {
         const auto& triad = getChordQualityData(quality).triadOffsets;
         std::vector<int> res;
-        res.reserve(13);
+        res.reserve(StrumVoicing::MAX_NOTES);
 
-        for (int shift : {-12, 0, 12, 24}) {
+        // Enough octaves for the longest plate; a standard 13 zone plate uses the first 13 notes, ending on root + 36
+        for (int shift = -12; res.size() < StrumVoicing::MAX_NOTES; shift += 12) {
             for (int o : triad) {
                 res.push_back(root + shift + o);
             }
         }
-        // 13th element is one more octave up
-        res.push_back(root + 36);
+        res.resize(StrumVoicing::MAX_NOTES);
         return res;
     }
 };